@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ConstraintPass.hpp"
+#include "ThreadPool.hpp"
+#include "TypeManager.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace typecheck {
+	// Solves independent managers concurrently, returning each one's `solve()` in input
+	// order. The managers must not be modified until this returns. If a solve throws,
+	// the first exception is rethrown once every solve is done.
+	auto solveAll(std::span<const TypeManager* const> managers, ThreadPool& pool) -> std::vector<std::optional<ConstraintPass>>;
+
+	// As above, on a pool of `threads` workers made for the call; 0 uses one per hardware thread.
+	auto solveAll(std::span<const TypeManager* const> managers, std::size_t threads = 0) -> std::vector<std::optional<ConstraintPass>>;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace typecheck {
+	// Lets another thread stop a solve. Copies share one flag, so the caller keeps a
+	// copy and hands another to the solve through SolveOptions.
+	class CancellationToken {
+	public:
+		CancellationToken();
+
+		void cancel() noexcept;
+		[[nodiscard]] auto isCancelled() const noexcept -> bool;
+
+	private:
+		std::shared_ptr<std::atomic<bool>> cancelled;
+	};
+}
@@ -2,9 +2,9 @@
 
 #include "TypeVar.hpp"
 #include "Type.hpp"
+#include "TypeTable.hpp"
 
 #include <memory>                            // for unique_ptr
-#include <string>
 #include <unordered_map>                     // for unordered_map
 
 
@@ -17,9 +17,14 @@ namespace typecheck {
 		[[nodiscard]] auto GetResolvedType(const TypeVar& var) const -> Type;
 		[[nodiscard]] auto HasResolvedType(const TypeVar& var) const -> bool;
 		auto SetResolvedType(const TypeVar& var, const Type& type) -> bool;
+		// Resolves `var` to whatever `other` resolved to, false if `other` is unresolved.
+		auto SetResolvedAlias(const TypeVar& var, const TypeVar& other) -> bool;
 
 	private:
-        // The key must be string, because 'typeVar' not comparable.
-        std::unordered_map<std::string, Type> resolvedTypes;
+        // Many variables resolve to the same handful of types, so each distinct type is stored once.
+        TypeTable types;
+
+        // Keyed by the type variable's handle, so lookups never touch its debug name.
+        std::unordered_map<TypeVar::IDType, TypeTable::IDType> resolvedTypes;
 	};
 }
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Constraint.hpp"
+#include "KnownProtocolKind.hpp"
+#include "TypeTable.hpp"
+#include "TypeVar.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace typecheck {
+	// Structure-of-arrays view of a TypeManager's constraints.  Each kind lives in its
+	// own contiguous array of fixed-size records, so the solver can sweep one kind at a
+	// time without touching the variant payloads of `Constraint`.
+	class ConstraintStore {
+	public:
+		// Equal, Conversion and ArrayElement (first is the array, second the element).
+		struct Relation {
+			Constraint::IDType id;
+			TypeVar first;
+			TypeVar second;
+		};
+
+		struct Conforms {
+			Constraint::IDType id;
+			TypeVar var;
+			KnownProtocolKind protocol;
+		};
+
+		// Bind, the type is a TypeTable ID.
+		struct Bind {
+			Constraint::IDType id;
+			TypeVar var;
+			TypeTable::IDType type;
+		};
+
+		// BindOverload, the argument vars are [argsBegin, argsBegin + numArgs) of `args`.
+		struct Overload {
+			Constraint::IDType id;
+			Constraint::IDType functionID;
+			TypeVar type;
+			TypeVar returnVar;
+			std::uint32_t argsBegin;
+			std::uint32_t numArgs;
+		};
+
+		// Size of every array, see `truncate`.
+		struct Mark {
+			std::size_t equals = 0;
+			std::size_t conversions = 0;
+			std::size_t arrayElements = 0;
+			std::size_t conforms = 0;
+			std::size_t binds = 0;
+			std::size_t overloads = 0;
+			std::size_t args = 0;
+		};
+
+		ConstraintStore() = default;
+		~ConstraintStore() = default;
+
+		// Adds the record for `constraint`, interning any bound type into `types`.
+		void add(const Constraint& constraint, TypeTable& types);
+		void clear() noexcept;
+
+		// Drops every record added after `mark` was taken, keeping the arrays' capacity.
+		[[nodiscard]] auto mark() const noexcept -> Mark;
+		void truncate(const Mark& mark);
+
+		// Drops the records of the constraints in `ids`, which must be sorted. The other
+		// records keep their order.
+		void remove(std::span<const Constraint::IDType> ids);
+
+		[[nodiscard]] auto equals() const noexcept -> std::span<const Relation>;
+		[[nodiscard]] auto conversions() const noexcept -> std::span<const Relation>;
+		[[nodiscard]] auto arrayElements() const noexcept -> std::span<const Relation>;
+		[[nodiscard]] auto conforms() const noexcept -> std::span<const Conforms>;
+		[[nodiscard]] auto binds() const noexcept -> std::span<const Bind>;
+		[[nodiscard]] auto overloads() const noexcept -> std::span<const Overload>;
+		[[nodiscard]] auto args(const Overload& overload) const -> std::span<const TypeVar>;
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+		[[nodiscard]] auto empty() const noexcept -> bool;
+
+	private:
+		std::vector<Relation> _equals;
+		std::vector<Relation> _conversions;
+		std::vector<Relation> _arrayElements;
+		std::vector<Conforms> _conforms;
+		std::vector<Bind> _binds;
+		std::vector<Overload> _overloads;
+		std::vector<TypeVar> _args; // Argument vars of every overload, back to back
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace typecheck {
+	// Square bit matrix of which types convert to which, indexed by registration order.
+	// Row `from` holds the types `from` converts to, the transposed rows the types
+	// converting to a type, so checks are bit tests and rows combine a word at a time.
+	class ConvertibilityMatrix {
+	public:
+		using Word = std::uint64_t;
+		static constexpr std::size_t wordBits = 64;
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+		ConvertibilityMatrix() = default;
+		~ConvertibilityMatrix() = default;
+
+		// Empties the matrix and resizes it to `size` types.
+		void reset(std::size_t size);
+		void set(std::size_t from, std::size_t to);
+		// Adds every conversion reachable through a chain of them.
+		void close();
+
+		[[nodiscard]] auto converts(std::size_t from, std::size_t to) const noexcept -> bool;
+		[[nodiscard]] auto to(std::size_t from) const -> std::span<const Word>;
+		[[nodiscard]] auto from(std::size_t to) const -> std::span<const Word>;
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+		// Words in a row, and in any bitset over the same types.
+		[[nodiscard]] auto words() const noexcept -> std::size_t;
+
+	private:
+		std::size_t _size = 0;
+		std::size_t _words = 0;
+		std::vector<Word> _to; // Row-major, `_words` per row
+		std::vector<Word> _from; // Transpose of `_to`
+	};
+}
@@ -2,10 +2,21 @@
 
 #include "TypeVar.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
 namespace typecheck {
+	// Binary handle for a registered overload: its function ID and its position in
+	// that function's overload family. This is what the solver works with.
+	struct OverloadKey {
+		long long functionID = 0;
+		std::uint32_t index = 0;
+
+		auto operator==(const OverloadKey& other) const noexcept -> bool = default;
+	};
+
 	class FunctionVar {
 	public:
 		FunctionVar();
@@ -20,6 +31,7 @@ namespace typecheck {
 		[[nodiscard]] auto args() const -> const std::vector<TypeVar>&;
 		auto add_args() -> TypeVar*;
 
+        // Text form, e.g. "T1,T2,|T3|name|42", for debug output only.
         [[nodiscard]] auto serialize() const -> std::string;
         static auto unserialize(const std::string& str) -> FunctionVar;
 
@@ -32,3 +44,10 @@ namespace typecheck {
 		long long _id;
 	};
 }
+
+template<>
+struct std::hash<typecheck::OverloadKey> {
+	auto operator()(const typecheck::OverloadKey& key) const noexcept -> std::size_t {
+		return std::hash<long long>()(key.functionID) ^ (std::hash<std::uint32_t>()(key.index) << 1);
+	}
+};
@@ -12,6 +12,10 @@ namespace typecheck {
         auto next() -> std::string;
         auto next_id() -> value_type;
 
+        // The ID `next_id` will hand out, and winding it back to an earlier one.
+        [[nodiscard]] auto peek_id() const noexcept -> value_type;
+        void rewind(value_type id) noexcept;
+
     private:
         value_type curr_num = 0;
 	};
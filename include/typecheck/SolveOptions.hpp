@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CancellationToken.hpp"
+#include "ConstraintPass.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace typecheck {
+	// Limits on one call to TypeManager::solve. The defaults search until done.
+	struct SolveOptions {
+		std::size_t maxNodes = 0; // Search nodes expanded over every group, 0 for no limit. Split evenly when racing, see TypeManager::setPortfolioSolve
+		std::optional<std::chrono::steady_clock::time_point> deadline;
+		bool partialResult = false; // Return the best assignment found when a limit is hit
+		std::optional<CancellationToken> cancellation; // Polled with the limits, every few expansions
+	};
+
+	enum class SolveStatus : std::uint8_t {
+		Solved,
+		Unsatisfiable, // Some group has no solution, see SolveStats::failedComponents
+		TimedOut, // Ran out of nodes or time first
+		Cancelled, // The cancellation token was cancelled first
+	};
+
+	struct SolveResult {
+		SolveStatus status = SolveStatus::Unsatisfiable;
+		// The solution when solved. When timed out, the groups that finished and the best
+		// assignment of the others found so far, if `partialResult` asked for it.
+		std::optional<ConstraintPass> pass;
+	};
+}
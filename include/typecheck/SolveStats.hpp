@@ -0,0 +1,19 @@
+#pragma once
+
+#include "TypeVar.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace typecheck {
+	// What a call to TypeManager::solve did, filled in when asked for.
+	struct SolveStats {
+		std::size_t variables = 0; // Solver variables, one per class of Equal type vars
+		std::size_t prunedValues = 0; // Domain values removed by propagation before search
+		std::size_t components = 0; // Groups of solver variables that share no constraint, solved separately
+		std::size_t reusedComponents = 0; // Groups whose result an incremental solve kept from the last solve
+		bool searched = false; // False when propagation alone decided the result
+		std::size_t nodes = 0; // Search nodes expanded, over every group
+		std::vector<std::vector<TypeVar>> failedComponents; // Type vars of each group with no solution
+	};
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace typecheck {
+	// Fixed set of worker threads, each with its own task queue. A worker runs its
+	// newest task first and steals the oldest task of another worker when idle.
+	class ThreadPool {
+	public:
+		using Task = std::function<void()>;
+
+		// `threads` of 0 uses one worker per hardware thread.
+		explicit ThreadPool(std::size_t threads = 0);
+		~ThreadPool();
+
+		// Not moveable or copyable
+		ThreadPool(const ThreadPool&) = delete;
+		auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+
+		void post(Task task);
+
+		template<typename F>
+		auto submit(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+			using Result = std::invoke_result_t<std::decay_t<F>>;
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+			auto future = task->get_future();
+			this->post([task]() { (*task)(); });
+			return future;
+		}
+
+		// Calls `body(i)` for every i in [0, count) and returns once all calls are done.
+		// The calling thread takes indices too, so this is safe from inside a pool task.
+		void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+	private:
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void work(std::size_t index);
+		auto pop(std::size_t index, Task& task) -> bool;
+
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> workers;
+		std::atomic<std::size_t> nextQueue = 0;
+
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+		std::size_t pending = 0; // Queued tasks, guarded by sleepMutex
+		bool stopping = false;
+	};
+}
@@ -2,14 +2,26 @@
 
 #include "Constraint.hpp"
 #include "ConstraintPass.hpp"
+#include "ConstraintStore.hpp"
+#include "ConvertibilityMatrix.hpp"
 #include "FunctionVar.hpp"
 #include "GenericTypeGenerator.hpp"
+#include "SolveOptions.hpp"
+#include "SolveStats.hpp"
+#include "ThreadPool.hpp"
+#include "TypeTable.hpp"
 
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace typecheck {
@@ -17,7 +29,7 @@ namespace typecheck {
 	class TypeManager {
 	public:
 		TypeManager();
-		~TypeManager() = default;
+		~TypeManager();
 
 		// Not moveable or copyable
 		TypeManager(const TypeManager&) = delete;
@@ -39,6 +51,15 @@ namespace typecheck {
         [[nodiscard]] auto isConvertible(const std::string& T0, const std::string& T1) const noexcept -> bool;
 		[[nodiscard]] auto isConvertible(const Type& T0, const Type& T1) const noexcept -> bool;
         [[nodiscard]] auto getConvertible(const Type& T0) const -> std::vector<Type>;
+		// Lets `solve` chain conversions, A -> B and B -> C allow A -> C. Off by default.
+		void setConvertibleTransitive(bool transitive);
+
+		// Every type the manager has seen, interned once.
+		[[nodiscard]] auto getTypeTable() const noexcept -> const TypeTable&;
+		// The constraints laid out per kind, as the solver reads them.
+		[[nodiscard]] auto getConstraintStore() const noexcept -> const ConstraintStore&;
+		// Every constraint in creation order, changed only through the Create* and remove calls.
+		[[nodiscard]] auto getConstraints() const noexcept -> std::span<const Constraint>;
 
 		auto CreateTypeVar() -> const typecheck::TypeVar;
 		[[nodiscard]] auto CreateFunctionHash(const std::string& name, const std::vector<std::string>& argNames) const -> Constraint::IDType;
@@ -55,22 +76,122 @@ namespace typecheck {
 
         [[nodiscard]] auto getConstraint(Constraint::IDType id) const -> const Constraint*;
 
-		auto solve() -> std::optional<ConstraintPass>;
-		std::vector<Constraint> constraints;
+		// Retracts constraints, with the element equality an Equal between two arrays
+		// generated and the element an ArrayElement recorded for its array. Unknown IDs are
+		// skipped, the rest keep their order. A mark taken before a removal can't be reset to.
+		auto removeConstraint(Constraint::IDType id) -> bool;
+		auto removeConstraints(std::span<const Constraint::IDType> ids) -> std::size_t;
+
+		// Snapshot of everything created so far. Type vars, constraints, overloads and
+		// the types they interned after the mark are dropped by `resetToMark`, which
+		// keeps registered types, convertibility and the storage's capacity for reuse.
+		struct Mark {
+			TypeVar::IDType numTypeVars = 0;
+			std::size_t numConstraints = 0;
+			Constraint::IDType nextConstraintID = 0;
+			ConstraintStore::Mark store;
+			std::size_t numTypes = 0;
+			std::size_t numOverloads = 0;
+			std::size_t numArrayElements = 0;
+			std::size_t removals = 0; // Removals made before it, see `removeConstraints`
+		};
+		[[nodiscard]] auto mark() const noexcept -> Mark;
+		void resetToMark(const Mark& mark);
+
+		// Checkpoints for speculative checking. `popScope` drops everything created since
+		// the matching `pushScope`, as `resetToMark` does, in time proportional to what was
+		// created; `commitScope` keeps it as part of the enclosing scope. Constraints can't
+		// be removed while a scope is open.
+		void pushScope();
+		void popScope();
+		void commitScope();
+		[[nodiscard]] auto scopeDepth() const noexcept -> std::size_t;
+
+		// Leaves the manager as it was, so it can be called repeatedly, and from several
+		// threads at once, as long as nothing modifies the manager meanwhile.
+		auto solve() const -> std::optional<ConstraintPass>;
+		auto solve(SolveStats* stats) const -> std::optional<ConstraintPass>;
+		// Stops searching once `options` runs out, see SolveResult.
+		auto solve(const SolveOptions& options, SolveStats* stats = nullptr) const -> SolveResult;
+
+		// Solves on `executor`, or on a thread of its own without one. The manager must not
+		// be modified until the solve is done. Exceptions of the solve reach the future.
+		auto solveAsync(const SolveOptions& options = {}, ThreadPool* executor = nullptr) const -> std::future<SolveResult>;
+		// Hands the result to `done` on the thread that solved; the future is ready once
+		// `done` returns.
+		auto solveAsync(const SolveOptions& options, std::function<void(SolveResult)> done, ThreadPool* executor = nullptr) const -> std::future<void>;
+
+		// Searches independent groups of constraints on a pool of `threads` workers.
+		// 0 or 1 (the default) searches on the calling thread; results are the same either way.
+		void setSolveThreads(std::size_t threads);
+		[[nodiscard]] auto getSolveThreads() const noexcept -> std::size_t;
+
+		// Keeps each searched group's result between solves, and reuses it while the group's
+		// vars, domains and constraints are unchanged, so a solve after a small edit only
+		// searches what the edit reached. An overload only reaches the groups calling its
+		// function. Registering types or conversions, and `resetToMark`, drop everything
+		// kept. Concurrent incremental solves take turns.
+		void setIncrementalSolve(bool incremental);
+		[[nodiscard]] auto isIncrementalSolve() const noexcept -> bool;
+
+		// Races searches that try each group's vars in different orders (as given, fewest
+		// values first, overload choices first, literals first) on the solve threads. Every
+		// order of every group searched gets its own even share of `SolveOptions::maxNodes`,
+		// at least one node. Takes the order that finished in the fewest expansions, the
+		// earlier one on a tie, and stops the rest once they expanded more, so short of a
+		// deadline the result doesn't depend on thread timing. Has no effect without
+		// `setSolveThreads` above 1. Off by default.
+		void setPortfolioSolve(bool portfolio);
+		[[nodiscard]] auto isPortfolioSolve() const noexcept -> bool;
 
 	private:
-		std::vector<Type> registeredTypes;
-		std::set<std::string> registeredTypeVars;
+		TypeTable typeTable;
+		std::vector<TypeTable::IDType> registeredTypes; // In registration order
+		std::vector<bool> registeredTypeIndex; // Indexed by TypeTable ID
+		std::size_t pinnedTypes = 0; // Types below this ID survive `resetToMark`
+		TypeVar::IDType numTypeVars = 0; // Type vars are handed out densely, [0, numTypeVars)
 		std::map<std::string, std::set<std::string>> convertible;
-		std::vector<FunctionVar> functions;
-		std::map<std::string, std::string> arrayElementMap; // Maps array type var to element type var
+		mutable ConvertibilityMatrix conversionMatrix; // `convertible` over registered types, rebuilt by `solve` when stale
+		mutable bool conversionMatrixStale = true;
+		mutable std::mutex conversionMatrixMutex;
+		bool transitiveConversions = false;
+		std::unordered_map<Constraint::IDType, std::vector<FunctionVar>> functions; // Overload families, keyed by function ID
+		std::vector<Constraint::IDType> functionOrder; // Function IDs, in order of first registration
+		std::unordered_map<TypeVar, TypeVar> arrayElementMap; // Maps array type var to element type var
+		std::unordered_map<Constraint::IDType, Constraint::IDType> derivedConstraints; // Equal -> the element equality it generated
+
+		// Undo logs for `resetToMark`.
+		std::vector<Constraint::IDType> overloadLog; // Function ID of every overload, in registration order
+		std::vector<std::pair<TypeVar, std::optional<TypeVar>>> arrayElementLog; // Array var and the element var it replaced
+		std::vector<Mark> scopes; // Open scopes, innermost last
+		std::size_t removals = 0; // Calls to `removeConstraints` that removed anything
 
-		GenericTypeGenerator type_generator;
 		GenericTypeGenerator constraint_generator;
 
-        [[nodiscard]] auto getFunctionOverloads(Constraint::IDType funcID) const -> std::vector<FunctionVar>;
+		[[nodiscard]] auto hasTypeVar(const TypeVar& var) const noexcept -> bool;
+		[[nodiscard]] auto findRegisteredType(const Type& name) const noexcept -> TypeTable::IDType;
+		void buildConversionMatrix() const;
+
+        // Non-owning view of a function's overloads, invalidated when another overload of it is registered.
+        [[nodiscard]] auto getFunctionOverloads(Constraint::IDType funcID) const -> std::span<const FunctionVar>;
+        [[nodiscard]] auto getFunctionOverload(const OverloadKey& key) const -> const FunctionVar&;
+
+        std::vector<Constraint> constraints; // In creation order, only written alongside `store` and `constraintSlots`
+        // Maps constraint ID -> index into `constraints`
+        std::vector<std::size_t> constraintSlots;
+        // Mirrors `constraints`, this is what `solve` sweeps.
+        ConstraintStore store;
+        // Set by `setSolveThreads`, null when solving on the calling thread.
+        std::unique_ptr<ThreadPool> solvePool;
+        // Set by `setIncrementalSolve`, null when every solve starts from scratch.
+        struct SolveCache;
+        std::unique_ptr<SolveCache> solveCache;
+        // Set by `setPortfolioSolve`.
+        bool portfolioSolve = false;
+        void invalidateSolveCache();
 
         // Internal helper
+        auto addConstraint(const Constraint& constraint) -> Constraint::IDType;
         auto getConstraintInternal(Constraint::IDType id) -> Constraint*;
 	};
 }
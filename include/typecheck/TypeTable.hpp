@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Type.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace typecheck {
+	// Hash-consed store of structural types.  Each distinct type (including its
+	// generic params and function signature) is stored once and referred to by ID,
+	// so two interned types are equal iff their IDs are equal.
+	class TypeTable {
+	public:
+		using IDType = std::uint32_t;
+		static constexpr IDType npos = std::numeric_limits<IDType>::max();
+
+		TypeTable() = default;
+		~TypeTable() = default;
+
+		// Returns the ID for `type`, adding it (and any nested types) if not present.
+		auto intern(const Type& type) -> IDType;
+		// Same as `intern`, built from the IDs of the already interned params.
+		auto intern_generic(const std::string& name, const std::vector<IDType>& params) -> IDType;
+
+		// Returns the ID for `type` if it has been interned, otherwise `npos`.
+		[[nodiscard]] auto find(const Type& type) const -> IDType;
+
+		[[nodiscard]] auto get(IDType id) const -> const Type&;
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+
+		// Drops every type with an ID of `size` or above, IDs below it are untouched.
+		void truncate(std::size_t size);
+
+		// Structural accessors, these never materialize a `Type`.
+		[[nodiscard]] auto has_generic(IDType id) const -> bool;
+		[[nodiscard]] auto has_func(IDType id) const -> bool;
+		[[nodiscard]] auto name(IDType id) const -> const std::string&;
+		// Generic type params, or function arguments.
+		[[nodiscard]] auto params(IDType id) const -> const std::vector<IDType>&;
+		// Function return type, or `npos` if there is none.
+		[[nodiscard]] auto returntype(IDType id) const -> IDType;
+
+	private:
+		enum class Kind : std::uint8_t {
+			None = 0,
+			Generic,
+			Func,
+		};
+
+		struct Node {
+			Kind kind = Kind::None;
+			std::string name;
+			long long funcID = 0;
+			std::vector<IDType> params;
+			IDType returnType = npos;
+
+			auto operator==(const Node& other) const noexcept -> bool;
+		};
+
+		static auto hash(const Node& node) noexcept -> std::size_t;
+		[[nodiscard]] auto lookup(const Node& node, std::size_t hash) const -> IDType;
+		auto insert(Node&& node, const Type& type) -> IDType;
+
+		std::vector<Node> nodes;
+		// Stable references for `get`, one per node.
+		std::deque<Type> types;
+		std::unordered_multimap<std::size_t, IDType> index;
+	};
+}
@@ -1,11 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <string>
 
 namespace typecheck {
 	class TypeVar {
 	public:
-		TypeVar(std::string s = "");
+		// Type variables are dense handles into the owning TypeManager's symbol table.
+		using IDType = std::uint32_t;
+		static constexpr IDType npos = std::numeric_limits<IDType>::max();
+
+		TypeVar() noexcept = default;
+		explicit TypeVar(IDType id) noexcept;
 		~TypeVar() = default;
 
 		auto operator==(const TypeVar& other) const noexcept -> bool;
@@ -14,11 +22,22 @@ namespace typecheck {
 
 		void CopyFrom(const TypeVar& other);
 
+		[[nodiscard]] auto id() const noexcept -> IDType;
+		void set_id(IDType id) noexcept;
+		[[nodiscard]] auto empty() const noexcept -> bool;
+
+		// Human readable name (T0, T1, ...), only built for debugging and solver boundaries.
 		[[nodiscard]] auto symbol() const -> std::string;
-		void set_symbol(const std::string& s);
 
 		[[nodiscard]] auto ShortDebugString() const -> std::string;
 	private:
-		std::string _symbol;
+		IDType _id = npos;
 	};
 }
+
+template<>
+struct std::hash<typecheck::TypeVar> {
+	auto operator()(const typecheck::TypeVar& var) const noexcept -> std::size_t {
+		return std::hash<typecheck::TypeVar::IDType>()(var.id());
+	}
+};
@@ -39,5 +39,31 @@ NEW_TEST(ArrayFunctionReturnTest, EmptyArrayWithExplicitReturnType) {
     CPPTEST_EXPECT_EQ(resolvedEmpty.generic().type_params(0).generic().name(), "string");
 }
 
+// Test: let x: [[int]] = [[]]
+NEW_TEST(ArrayFunctionReturnTest, BindNestedArrayType) {
+    getDefaultTypeManager(tm);
+
+    typecheck::GenericType innerType("Array");
+    innerType.add_type_param()->CopyFrom(tm.getRegisteredType("int"));
+    typecheck::GenericType outerType("Array");
+    outerType.add_type_param()->CopyFrom(typecheck::Type(innerType));
+
+    auto arrayVar = tm.CreateTypeVar();
+    auto elementVar = tm.CreateTypeVar();
+    tm.CreateArrayElementConstraint(arrayVar, elementVar);
+    tm.CreateBindToConstraint(arrayVar, typecheck::Type(outerType));
+
+    const auto solution = tm.solve();
+    CPPTEST_ASSERT_THAT(solution.has_value());
+
+    auto resolvedElement = solution->GetResolvedType(elementVar);
+    CPPTEST_EXPECT_EQ(resolvedElement.generic().name(), "Array");
+    CPPTEST_ASSERT_THAT(resolvedElement.generic().type_params_size() == 1);
+    CPPTEST_EXPECT_EQ(resolvedElement.generic().type_params(0).generic().name(), "int");
+
+    auto resolvedArray = solution->GetResolvedType(arrayVar);
+    CPPTEST_EXPECT_EQ(resolvedArray, typecheck::Type(outerType));
+}
+
 CPPTEST_END_CLASS(ArrayFunctionReturnTest)
 
@@ -0,0 +1,23 @@
+#include "typecheck/BatchSolve.hpp"
+
+auto typecheck::solveAll(const std::span<const TypeManager* const> managers, ThreadPool& pool) -> std::vector<std::optional<ConstraintPass>> {
+	std::vector<std::optional<ConstraintPass>> results(managers.size());
+	pool.parallelFor(managers.size(), [&managers, &results](const std::size_t i) {
+		results.at(i) = managers[i]->solve();
+	});
+	return results;
+}
+
+auto typecheck::solveAll(const std::span<const TypeManager* const> managers, const std::size_t threads) -> std::vector<std::optional<ConstraintPass>> {
+	if (managers.size() < 2 || threads == 1) {
+		std::vector<std::optional<ConstraintPass>> results;
+		results.reserve(managers.size());
+		for (const auto* manager : managers) {
+			results.push_back(manager->solve());
+		}
+		return results;
+	}
+
+	ThreadPool pool(threads);
+	return solveAll(managers, pool);
+}
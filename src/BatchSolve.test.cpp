@@ -0,0 +1,102 @@
+#include "cpptest/cpptest.hpp"
+#include "Utils.test.hpp"
+#include "typecheck/BatchSolve.hpp"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
+#include <iostream>
+#include <thread>
+#endif
+
+class BatchSolveTest : public cpptest::BaseCppTest {
+public:
+    void SetUp() {
+        // Run before every test
+    }
+
+    void TearDown() {
+        // Run After every test
+    }
+};
+
+CPPTEST_CLASS(BatchSolveTest)
+
+namespace {
+    // One function body: `let a = <literal>; let b: <type> = a; foo(b)`.
+    auto buildBody(typecheck::TypeManager& tm, const std::string& type) -> std::vector<typecheck::TypeVar> {
+        const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+        tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("int"));
+        tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("double")}, tm.getRegisteredType("float"));
+
+        const auto T = CreateMultipleSymbols(tm, 4);
+        tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+        tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType(type));
+        tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+        tm.CreateBindFunctionConstraint(fooHash, T.at(2), {T.at(1)}, T.at(3));
+        return T;
+    }
+}
+
+NEW_TEST(BatchSolveTest, ResultsKeepInputOrder) {
+    const std::vector<std::string> types{"float", "double", "void", "float"};
+    std::vector<std::unique_ptr<typecheck::TypeManager>> owners;
+    std::vector<const typecheck::TypeManager*> managers;
+    std::vector<std::vector<typecheck::TypeVar>> vars;
+    for (const auto& type : types) {
+        auto& tm = *owners.emplace_back(std::make_unique<typecheck::TypeManager>());
+        setupTypeManager(&tm);
+        vars.push_back(buildBody(tm, type));
+        managers.push_back(&tm);
+    }
+
+    const auto results = typecheck::solveAll(managers, 3);
+    CPPTEST_ASSERT_THAT(results.size() == types.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto expected = managers.at(i)->solve();
+        CPPTEST_ASSERT_THAT(results.at(i).has_value() == expected.has_value());
+        if (expected.has_value()) {
+            CPPTEST_EXPECT_EQ(results.at(i)->GetResolvedType(vars.at(i).at(3)), expected->GetResolvedType(vars.at(i).at(3)));
+        }
+    }
+    // No overload of foo takes void.
+    CPPTEST_EXPECT_FALSE(results.at(2).has_value());
+    CPPTEST_EXPECT_EQ(results.at(1)->GetResolvedType(vars.at(1).at(3)), managers.at(1)->getRegisteredType("float"));
+
+    typecheck::ThreadPool pool(2);
+    CPPTEST_EXPECT_TRUE(typecheck::solveAll(std::span<const typecheck::TypeManager* const>(), pool).empty());
+}
+
+NEW_TEST(BatchSolveTest, BenchmarkSolveAll1kBodies) {
+    constexpr std::size_t numBodies = 1000;
+    std::vector<std::unique_ptr<typecheck::TypeManager>> owners;
+    std::vector<const typecheck::TypeManager*> managers;
+    for (std::size_t i = 0; i < numBodies; ++i) {
+        auto& tm = *owners.emplace_back(std::make_unique<typecheck::TypeManager>());
+        setupTypeManager(&tm);
+        buildBody(tm, i % 2 == 0 ? "float" : "double");
+        managers.push_back(&tm);
+    }
+
+    auto solvesPerSecond = [&managers](const std::size_t threads) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto results = typecheck::solveAll(managers, threads);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        for (const auto& result : results) {
+            CPPTEST_EXPECT_TRUE(result.has_value());
+        }
+        return static_cast<double>(results.size()) / elapsed.count();
+    };
+
+    const auto serial = solvesPerSecond(1);
+    const auto parallel = solvesPerSecond(0);
+    CPPTEST_EXPECT_TRUE(serial > 0 && parallel > 0);
+#ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
+    std::cout << "Batch solve (" << numBodies << " bodies): " << static_cast<std::size_t>(serial) << " solves/s serial, "
+        << static_cast<std::size_t>(parallel) << " solves/s on " << std::thread::hardware_concurrency() << " threads" << std::endl;
+#endif
+}
+
+CPPTEST_END_CLASS(BatchSolveTest)
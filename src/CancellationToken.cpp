@@ -0,0 +1,11 @@
+#include "typecheck/CancellationToken.hpp"
+
+typecheck::CancellationToken::CancellationToken() : cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+void typecheck::CancellationToken::cancel() noexcept {
+	this->cancelled->store(true, std::memory_order_relaxed);
+}
+
+auto typecheck::CancellationToken::isCancelled() const noexcept -> bool {
+	return this->cancelled->load(std::memory_order_relaxed);
+}
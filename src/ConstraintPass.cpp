@@ -11,21 +11,28 @@ auto typecheck::ConstraintPass::GetResolvedType(const TypeVar& var) const -> Typ
         return type;
     }
 
-    return this->resolvedTypes.at(var.symbol());
+    return this->types.get(this->resolvedTypes.at(var.id()));
 }
 
 auto typecheck::ConstraintPass::HasResolvedType(const TypeVar& var) const -> bool {
-    return this->resolvedTypes.find(var.symbol()) != this->resolvedTypes.end();
+    return this->resolvedTypes.find(var.id()) != this->resolvedTypes.end();
 }
 
 auto typecheck::ConstraintPass::SetResolvedType(const TypeVar& var, const Type& type) -> bool {
-    if (!var.symbol().empty()) {
-        const auto [it, didInsert] = this->resolvedTypes.emplace(var.symbol(), type);
-        if (!didInsert) {
-            this->resolvedTypes.at(var.symbol()) = type;
-        }
+    if (!var.empty()) {
+        this->resolvedTypes.insert_or_assign(var.id(), this->types.intern(type));
         return true;
     }
 
     return false;
 }
+
+auto typecheck::ConstraintPass::SetResolvedAlias(const TypeVar& var, const TypeVar& other) -> bool {
+    const auto it = this->resolvedTypes.find(other.id());
+    if (var.empty() || it == this->resolvedTypes.end()) {
+        return false;
+    }
+
+    this->resolvedTypes.insert_or_assign(var.id(), it->second);
+    return true;
+}
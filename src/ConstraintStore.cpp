@@ -0,0 +1,162 @@
+#include "typecheck/ConstraintStore.hpp"
+#include "typecheck/Debug.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void typecheck::ConstraintStore::add(const Constraint& constraint, TypeTable& types) {
+	const auto id = constraint.id();
+
+	if (constraint.has_conforms()) {
+		const auto& conforms = constraint.conforms();
+		TYPECHECK_ASSERT(conforms.has_type() && conforms.has_protocol(), "Malformed Conforms Constraint");
+		this->_conforms.push_back(Conforms{id, conforms.type(), conforms.protocol()});
+	} else if (constraint.has_types()) {
+		const auto& vars = constraint.types();
+		TYPECHECK_ASSERT(vars.has_first() && vars.has_second(), "Malformed Types Constraint");
+		const Relation relation{id, vars.first(), vars.second()};
+		switch (constraint.kind()) {
+		case ConstraintKind::Equal:
+			this->_equals.push_back(relation);
+			break;
+		case ConstraintKind::Conversion:
+			this->_conversions.push_back(relation);
+			break;
+		case ConstraintKind::ArrayElement:
+			this->_arrayElements.push_back(relation);
+			break;
+		case ConstraintKind::Bind:
+		case ConstraintKind::BindParam:
+		case ConstraintKind::BindOverload:
+		case ConstraintKind::ConformsTo:
+		case ConstraintKind::ApplicableFunction:
+		default:
+			TYPECHECK_ASSERT(false, "Unimplemented Constraint Kind");
+			break;
+		}
+	} else if (constraint.has_overload()) {
+		const auto& overload = constraint.overload();
+		TYPECHECK_ASSERT(this->_args.size() + overload.argvars_size() <= std::numeric_limits<std::uint32_t>::max(), "Exhausted overload argument slots.");
+		const auto argsBegin = static_cast<std::uint32_t>(this->_args.size());
+		for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+			this->_args.push_back(overload.argvars(i));
+		}
+		this->_overloads.push_back(Overload{id, overload.functionid(), overload.type(), overload.returnvar(), argsBegin, static_cast<std::uint32_t>(overload.argvars_size())});
+	} else if (constraint.has_explicit()) {
+		const auto& explicit_ = constraint.explicit_();
+		TYPECHECK_ASSERT(explicit_.has_var() && explicit_.has_type(), "Malformed Explicit Constraint");
+		this->_binds.push_back(Bind{id, explicit_.var(), types.intern(explicit_.type())});
+	} else {
+		TYPECHECK_ASSERT(false, "Unknown Constraint Type");
+	}
+}
+
+void typecheck::ConstraintStore::clear() noexcept {
+	this->_equals.clear();
+	this->_conversions.clear();
+	this->_arrayElements.clear();
+	this->_conforms.clear();
+	this->_binds.clear();
+	this->_overloads.clear();
+	this->_args.clear();
+}
+
+auto typecheck::ConstraintStore::mark() const noexcept -> Mark {
+	return Mark{
+		this->_equals.size(),
+		this->_conversions.size(),
+		this->_arrayElements.size(),
+		this->_conforms.size(),
+		this->_binds.size(),
+		this->_overloads.size(),
+		this->_args.size(),
+	};
+}
+
+void typecheck::ConstraintStore::truncate(const Mark& mark) {
+	TYPECHECK_ASSERT(mark.equals <= this->_equals.size() &&
+		mark.conversions <= this->_conversions.size() &&
+		mark.arrayElements <= this->_arrayElements.size() &&
+		mark.conforms <= this->_conforms.size() &&
+		mark.binds <= this->_binds.size() &&
+		mark.overloads <= this->_overloads.size() &&
+		mark.args <= this->_args.size(), "Constraint store mark is newer than the store.");
+
+	this->_equals.resize(mark.equals);
+	this->_conversions.resize(mark.conversions);
+	this->_arrayElements.resize(mark.arrayElements);
+	this->_conforms.resize(mark.conforms);
+	this->_binds.resize(mark.binds);
+	this->_overloads.resize(mark.overloads);
+	this->_args.resize(mark.args);
+}
+
+void typecheck::ConstraintStore::remove(const std::span<const Constraint::IDType> ids) {
+	TYPECHECK_ASSERT(std::is_sorted(ids.begin(), ids.end()), "Constraint IDs to remove must be sorted.");
+	auto removed = [ids](const auto& record) {
+		return std::binary_search(ids.begin(), ids.end(), record.id);
+	};
+
+	std::erase_if(this->_equals, removed);
+	std::erase_if(this->_conversions, removed);
+	std::erase_if(this->_arrayElements, removed);
+	std::erase_if(this->_conforms, removed);
+	std::erase_if(this->_binds, removed);
+
+	// Each overload owns a run of `_args`, so rebuild them without the removed runs.
+	std::vector<TypeVar> args;
+	args.reserve(this->_args.size());
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < this->_overloads.size(); ++i) {
+		auto overload = this->_overloads[i];
+		if (removed(overload)) {
+			continue;
+		}
+
+		const auto begin = this->_args.begin() + overload.argsBegin;
+		const auto argsBegin = static_cast<std::uint32_t>(args.size());
+		args.insert(args.end(), begin, begin + overload.numArgs);
+		overload.argsBegin = argsBegin;
+		this->_overloads[kept++] = overload;
+	}
+	this->_overloads.resize(kept);
+	this->_args = std::move(args);
+}
+
+auto typecheck::ConstraintStore::equals() const noexcept -> std::span<const Relation> {
+	return this->_equals;
+}
+
+auto typecheck::ConstraintStore::conversions() const noexcept -> std::span<const Relation> {
+	return this->_conversions;
+}
+
+auto typecheck::ConstraintStore::arrayElements() const noexcept -> std::span<const Relation> {
+	return this->_arrayElements;
+}
+
+auto typecheck::ConstraintStore::conforms() const noexcept -> std::span<const Conforms> {
+	return this->_conforms;
+}
+
+auto typecheck::ConstraintStore::binds() const noexcept -> std::span<const Bind> {
+	return this->_binds;
+}
+
+auto typecheck::ConstraintStore::overloads() const noexcept -> std::span<const Overload> {
+	return this->_overloads;
+}
+
+auto typecheck::ConstraintStore::args(const Overload& overload) const -> std::span<const TypeVar> {
+	TYPECHECK_ASSERT(static_cast<std::size_t>(overload.argsBegin) + overload.numArgs <= this->_args.size(), "Overload arguments out of range.");
+	return std::span<const TypeVar>(this->_args).subspan(overload.argsBegin, overload.numArgs);
+}
+
+auto typecheck::ConstraintStore::size() const noexcept -> std::size_t {
+	return this->_equals.size() + this->_conversions.size() + this->_arrayElements.size() +
+		this->_conforms.size() + this->_binds.size() + this->_overloads.size();
+}
+
+auto typecheck::ConstraintStore::empty() const noexcept -> bool {
+	return this->size() == 0;
+}
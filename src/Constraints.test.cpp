@@ -1,6 +1,10 @@
 #include "cpptest/cpptest.hpp"
 #include "Utils.test.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 class ConstraintTest : public cpptest::BaseCppTest {
 public:
     void SetUp() {
@@ -326,6 +330,28 @@ NEW_TEST(ConstraintTest, SolveFunctionSameNumArgsDifferentTypeApplicationConstra
     CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(2)).generic().name(), "double");
 }
 
+NEW_TEST(ConstraintTest, SolveInterleavedOverloadFamilies) {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 3);
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+    const auto barHash = tm.CreateFunctionHash("bar", {"a"});
+
+    // Overloads of different functions registered out of order.
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("int") }, tm.getRegisteredType("double"));
+    tm.CreateApplicableFunctionConstraint(barHash, { tm.getRegisteredType("float") }, tm.getRegisteredType("int"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("float") }, tm.getRegisteredType("double"));
+
+    tm.CreateBindFunctionConstraint(barHash, T.at(0), { T.at(1) }, T.at(2));
+
+    const auto solution = tm.solve();
+    CPPTEST_ASSERT_THAT(solution.has_value());
+    CPPTEST_ASSERT_THAT(solution->GetResolvedType(T.at(0)).has_func());
+    CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(0)).func().id(), barHash);
+    CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(1)).generic().name(), "float");
+    CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(2)).generic().name(), "int");
+}
+
 NEW_TEST(ConstraintTest, SolveFunctionInferArgsLaterConstraint) {
     getDefaultTypeManager(tm);
     tm.registerType("void");
@@ -724,6 +750,601 @@ CREATE_STRESS_TEST(300)
 CREATE_STRESS_TEST(400)
 CREATE_STRESS_TEST(800)
 
+NEW_TEST(ConstraintTest, SolveLongEqualsChainResolvesEveryMember) {
+	getDefaultTypeManager(tm);
+
+	constexpr std::size_t numSymbols = 2000;
+	const auto T = CreateMultipleSymbols(tm, numSymbols);
+	for (std::size_t i = 1; i < numSymbols; ++i) {
+		tm.CreateEqualsConstraint(T.at(i - 1), T.at(i));
+	}
+	tm.CreateLiteralConformsToConstraint(T.at(numSymbols / 2), typecheck::KnownProtocolKind::ExpressibleByFloat);
+	tm.CreateBindToConstraint(T.back(), tm.getRegisteredType("double"));
+
+	const auto solution = tm.solve();
+	CPPTEST_ASSERT_THAT(solution.has_value());
+	for (const auto& var : T) {
+		CPPTEST_ASSERT_THAT(solution->HasResolvedType(var));
+		CPPTEST_EXPECT_EQ(solution->GetResolvedType(var), tm.getRegisteredType("double"));
+	}
+}
+
+NEW_TEST(ConstraintTest, PropagationDecidesWithoutSearch) {
+	getDefaultTypeManager(tm);
+	const auto T = CreateMultipleSymbols(tm, 4);
+
+	// let a: int = 1; let b: [int] = [a]; let c: double = a;
+	tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+	tm.CreateArrayElementConstraint(T.at(1), T.at(2));
+	tm.CreateEqualsConstraint(T.at(2), T.at(0));
+	tm.CreateBindToConstraint(T.at(3), tm.getRegisteredType("double"));
+	tm.CreateConvertibleConstraint(T.at(0), T.at(3));
+
+	typecheck::SolveStats stats;
+	const auto solution = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(solution.has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+	CPPTEST_EXPECT_THAT(stats.prunedValues > 0);
+	CPPTEST_EXPECT_EQ(stats.variables, 3);
+
+	const auto array = solution->GetResolvedType(T.at(1));
+	CPPTEST_EXPECT_EQ(array.generic().name(), "Array");
+	CPPTEST_EXPECT_EQ(array.generic().type_params(0), tm.getRegisteredType("int"));
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(2)), tm.getRegisteredType("int"));
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(3)), tm.getRegisteredType("double"));
+}
+
+NEW_TEST(ConstraintTest, PropagationRejectsInvalidConversion) {
+	getDefaultTypeManager(tm);
+	const auto T = CreateMultipleSymbols(tm, 2);
+
+	tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("double"));
+	tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("int"));
+	tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+
+	typecheck::SolveStats stats;
+	CPPTEST_EXPECT_FALSE(tm.solve(&stats).has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+}
+
+NEW_TEST(ConstraintTest, BoundOverloadCallDecidesWithoutSearch) {
+	getDefaultTypeManager(tm);
+	const auto T = CreateMultipleSymbols(tm, 4);
+
+	// func foo(a: Int) -> Double, func foo(a: Float) -> Int
+	const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+	tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("double"));
+	tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("int"));
+
+	// let a: Float = 1.0; let b = foo(a: a)
+	tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("float"));
+	tm.CreateBindFunctionConstraint(fooHash, T.at(0), {T.at(1)}, T.at(2));
+	tm.CreateEqualsConstraint(T.at(3), T.at(2));
+
+	typecheck::SolveStats stats;
+	const auto solution = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(solution.has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+	CPPTEST_ASSERT_THAT(solution->GetResolvedType(T.at(0)).has_func());
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(0)).func().args(0).generic().name(), "float");
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(3)).generic().name(), "int");
+}
+
+NEW_TEST(ConstraintTest, FailingComponentIsReported) {
+	getDefaultTypeManager(tm);
+	const auto T = CreateMultipleSymbols(tm, 4);
+
+	// Unrelated statement, solvable on its own.
+	tm.CreateEqualsConstraint(T.at(0), T.at(1));
+	tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+
+	tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("double"));
+	tm.CreateBindToConstraint(T.at(3), tm.getRegisteredType("int"));
+	tm.CreateConvertibleConstraint(T.at(2), T.at(3));
+
+	typecheck::SolveStats stats;
+	CPPTEST_EXPECT_FALSE(tm.solve(&stats).has_value());
+	CPPTEST_EXPECT_EQ(stats.components, 2);
+	CPPTEST_ASSERT_THAT(stats.failedComponents.size() == 1);
+	const auto& failed = stats.failedComponents.front();
+	CPPTEST_ASSERT_THAT(failed.size() == 2);
+	CPPTEST_EXPECT_EQ(failed.at(0).id(), T.at(2).id());
+	CPPTEST_EXPECT_EQ(failed.at(1).id(), T.at(3).id());
+}
+
+NEW_TEST(ConstraintTest, IndependentLiteralsSolveSeparately) {
+	getDefaultTypeManager(tm);
+	const auto T = CreateMultipleSymbols(tm, 3);
+
+	tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+	tm.CreateLiteralConformsToConstraint(T.at(1), typecheck::KnownProtocolKind::ExpressibleByFloat);
+	tm.CreateConvertibleConstraint(T.at(1), T.at(2));
+
+	typecheck::SolveStats stats;
+	const auto solution = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(solution.has_value());
+	CPPTEST_EXPECT_EQ(stats.components, 2);
+	CPPTEST_EXPECT_TRUE(stats.failedComponents.empty());
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(0)).generic().name(), "int");
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(1)).generic().name(), "float");
+}
+
+NEW_TEST(ConstraintTest, ParallelSolveMatchesSerial) {
+	constexpr std::size_t numStatements = 64;
+	auto build = [](typecheck::TypeManager& tm) {
+		std::vector<typecheck::TypeVar> T;
+		for (std::size_t i = 0; i < numStatements; ++i) {
+			// let a = <literal>; let b = a; f(b)
+			const auto literal = tm.CreateTypeVar();
+			const auto var = tm.CreateTypeVar();
+			const auto func = tm.CreateTypeVar();
+			const auto ret = tm.CreateTypeVar();
+			tm.CreateLiteralConformsToConstraint(literal, i % 2 == 0 ? typecheck::KnownProtocolKind::ExpressibleByInteger : typecheck::KnownProtocolKind::ExpressibleByFloat);
+			tm.CreateEqualsConstraint(var, literal);
+			tm.CreateBindFunctionConstraint(tm.CreateFunctionHash("f", {"_"}), func, {var}, ret);
+			T.insert(T.end(), {literal, var, func, ret});
+		}
+		return T;
+	};
+
+	getDefaultTypeManager(serial);
+	getDefaultTypeManager(parallel);
+	for (auto* tm : {&serial, &parallel}) {
+		for (const auto* arg : {"int", "float"}) {
+			tm->CreateApplicableFunctionConstraint(tm->CreateFunctionHash("f", {"_"}), {tm->getRegisteredType(arg)}, tm->getRegisteredType(arg));
+		}
+	}
+	parallel.setSolveThreads(4);
+	CPPTEST_EXPECT_EQ(parallel.getSolveThreads(), 4);
+
+	const auto T0 = build(serial);
+	const auto T1 = build(parallel);
+	typecheck::SolveStats serialStats;
+	typecheck::SolveStats parallelStats;
+	const auto expected = serial.solve(&serialStats);
+	const auto actual = parallel.solve(&parallelStats);
+	CPPTEST_ASSERT_THAT(expected.has_value() && actual.has_value());
+	CPPTEST_EXPECT_EQ(parallelStats.components, serialStats.components);
+	CPPTEST_EXPECT_TRUE(parallelStats.components >= numStatements);
+	for (std::size_t i = 0; i < T0.size(); ++i) {
+		CPPTEST_EXPECT_EQ(actual->GetResolvedType(T1.at(i)), expected->GetResolvedType(T0.at(i)));
+	}
+}
+
+NEW_TEST(ConstraintTest, PortfolioSolveMatchesSerial) {
+	getDefaultTypeManager(tm);
+	const auto fHash = tm.CreateFunctionHash("f", {"_"});
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("double"));
+
+	// f(<literal>), which only a search settles: the literal prefers int.
+	std::vector<std::pair<typecheck::TypeVar, std::string>> expected;
+	for (std::size_t i = 0; i < 16; ++i) {
+		const auto T = CreateMultipleSymbols(tm, 3);
+		tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+		tm.CreateBindFunctionConstraint(fHash, T.at(1), {T.at(0)}, T.at(2));
+		expected.emplace_back(T.at(0), "int");
+		expected.emplace_back(T.at(2), "float");
+	}
+	tm.setSolveThreads(4);
+	tm.setPortfolioSolve(true);
+	CPPTEST_EXPECT_TRUE(tm.isPortfolioSolve());
+
+	typecheck::SolveStats stats;
+	const auto solution = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(solution.has_value());
+	CPPTEST_EXPECT_TRUE(stats.components >= expected.size() / 2);
+	CPPTEST_EXPECT_TRUE(stats.searched);
+	tm.setPortfolioSolve(false);
+	const auto serial = tm.solve();
+	CPPTEST_ASSERT_THAT(serial.has_value());
+	for (const auto& [var, type] : expected) {
+		CPPTEST_EXPECT_EQ(solution->GetResolvedType(var), tm.getRegisteredType(type));
+		CPPTEST_EXPECT_EQ(solution->GetResolvedType(var), serial->GetResolvedType(var));
+	}
+
+	// Whichever order finishes first also settles a group with no solution.
+	tm.setPortfolioSolve(true);
+	const auto T = CreateMultipleSymbols(tm, 3);
+	tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+	tm.CreateBindFunctionConstraint(fHash, T.at(1), {T.at(0)}, T.at(2));
+	tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("void"));
+	CPPTEST_EXPECT_FALSE(tm.solve().has_value());
+}
+
+NEW_TEST(ConstraintTest, PortfolioSolveSplitsItsBudget) {
+	getDefaultTypeManager(tm);
+	const auto fHash = tm.CreateFunctionHash("f", {"_"});
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("double"));
+	std::vector<typecheck::TypeVar> vars;
+	for (std::size_t i = 0; i < 8; ++i) {
+		const auto T = CreateMultipleSymbols(tm, 3);
+		tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+		tm.CreateBindFunctionConstraint(fHash, T.at(1), {T.at(0)}, T.at(2));
+		vars.insert(vars.end(), T.begin(), T.end());
+	}
+	typecheck::SolveStats stats;
+	CPPTEST_ASSERT_THAT(tm.solve(typecheck::SolveOptions{}, &stats).pass.has_value());
+	const auto needed = stats.nodes;
+
+	// Every order of every statement gets an even share, which is enough for any of them here.
+	tm.setSolveThreads(4);
+	tm.setPortfolioSolve(true);
+	typecheck::SolveOptions options;
+	options.maxNodes = 4 * needed;
+	const auto first = tm.solve(options, &stats);
+	CPPTEST_EXPECT_THAT(first.status == typecheck::SolveStatus::Solved);
+	CPPTEST_ASSERT_THAT(first.pass.has_value());
+	CPPTEST_EXPECT_TRUE(stats.nodes <= options.maxNodes);
+
+	// The winning order doesn't depend on which thread finishes first.
+	for (std::size_t run = 0; run < 16; ++run) {
+		const auto again = tm.solve(options, &stats);
+		CPPTEST_ASSERT_THAT(again.pass.has_value());
+		CPPTEST_EXPECT_TRUE(stats.nodes <= options.maxNodes);
+		for (const auto& var : vars) {
+			CPPTEST_EXPECT_EQ(again.pass->GetResolvedType(var), first.pass->GetResolvedType(var));
+		}
+	}
+
+	// Shares round up, so a limit below the number of orders still lets every order
+	// search, and racing ends the way a single search does.
+	options.partialResult = true;
+	for (std::size_t maxNodes = 1; maxNodes <= 3; ++maxNodes) {
+		options.maxNodes = maxNodes;
+		tm.setPortfolioSolve(false);
+		const auto serial = tm.solve(options);
+		tm.setPortfolioSolve(true);
+		const auto raced = tm.solve(options, &stats);
+		CPPTEST_EXPECT_THAT(raced.status == serial.status);
+		CPPTEST_EXPECT_EQ(raced.pass.has_value(), serial.pass.has_value());
+		CPPTEST_EXPECT_TRUE(stats.nodes >= 4);
+	}
+}
+
+NEW_TEST(ConstraintTest, PortfolioSolveUnderBudgetIsRepeatable) {
+	getDefaultTypeManager(tm);
+	const auto fHash = tm.CreateFunctionHash("f", {"_"});
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("double"));
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("double")}, tm.getRegisteredType("int"));
+
+	// Statements of f(f(...f(<literal>))) nested to different depths, so some groups
+	// finish within their share and others run out.
+	std::vector<typecheck::TypeVar> vars;
+	for (std::size_t i = 0; i < 8; ++i) {
+		auto arg = tm.CreateTypeVar();
+		tm.CreateLiteralConformsToConstraint(arg, typecheck::KnownProtocolKind::ExpressibleByInteger);
+		vars.push_back(arg);
+		for (std::size_t depth = 0; depth <= i % 3; ++depth) {
+			const auto T = CreateMultipleSymbols(tm, 2);
+			tm.CreateBindFunctionConstraint(fHash, T.at(0), {arg}, T.at(1));
+			vars.insert(vars.end(), T.begin(), T.end());
+			arg = T.at(1);
+		}
+	}
+	typecheck::SolveStats stats;
+	CPPTEST_ASSERT_THAT(tm.solve(typecheck::SolveOptions{}, &stats).pass.has_value());
+	CPPTEST_EXPECT_TRUE(stats.components > 1);
+	const auto needed = stats.nodes;
+
+	tm.setSolveThreads(4);
+	tm.setPortfolioSolve(true);
+	typecheck::SolveOptions options;
+	options.maxNodes = needed;
+	options.partialResult = true;
+	const auto first = tm.solve(options, &stats);
+	CPPTEST_ASSERT_THAT(first.pass.has_value());
+	CPPTEST_EXPECT_THAT(first.status == typecheck::SolveStatus::TimedOut);
+	CPPTEST_EXPECT_TRUE(stats.nodes > 0);
+	for (std::size_t run = 0; run < 16; ++run) {
+		const auto again = tm.solve(options, &stats);
+		CPPTEST_EXPECT_THAT(again.status == first.status);
+		CPPTEST_ASSERT_THAT(again.pass.has_value());
+		for (const auto& var : vars) {
+			CPPTEST_ASSERT_THAT(again.pass->HasResolvedType(var) == first.pass->HasResolvedType(var));
+			if (first.pass->HasResolvedType(var)) {
+				CPPTEST_EXPECT_EQ(again.pass->GetResolvedType(var), first.pass->GetResolvedType(var));
+			}
+		}
+	}
+}
+
+NEW_TEST(ConstraintTest, SolveStopsAtItsBudget) {
+	getDefaultTypeManager(tm);
+	const auto fHash = tm.CreateFunctionHash("f", {"_"});
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("double"));
+
+	// let a: double = 1, settled by propagation, then calls only a search settles.
+	const auto bound = CreateMultipleSymbols(tm, 2);
+	tm.CreateBindToConstraint(bound.at(1), tm.getRegisteredType("double"));
+	tm.CreateEqualsConstraint(bound.at(0), bound.at(1));
+	for (std::size_t i = 0; i < 8; ++i) {
+		const auto T = CreateMultipleSymbols(tm, 3);
+		tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+		tm.CreateBindFunctionConstraint(fHash, T.at(1), {T.at(0)}, T.at(2));
+	}
+
+	typecheck::SolveStats stats;
+	const auto unlimited = tm.solve(typecheck::SolveOptions{}, &stats);
+	CPPTEST_EXPECT_THAT(unlimited.status == typecheck::SolveStatus::Solved);
+	CPPTEST_ASSERT_THAT(unlimited.pass.has_value());
+	const auto needed = stats.nodes;
+	CPPTEST_EXPECT_TRUE(needed > 1);
+
+	typecheck::SolveOptions options;
+	options.maxNodes = 1;
+	const auto outOfNodes = tm.solve(options, &stats);
+	CPPTEST_EXPECT_THAT(outOfNodes.status == typecheck::SolveStatus::TimedOut);
+	CPPTEST_EXPECT_FALSE(outOfNodes.pass.has_value());
+	CPPTEST_EXPECT_EQ(stats.nodes, 1);
+
+	// The partial pass has everything that didn't need the search.
+	options.partialResult = true;
+	const auto partial = tm.solve(options);
+	CPPTEST_EXPECT_THAT(partial.status == typecheck::SolveStatus::TimedOut);
+	CPPTEST_ASSERT_THAT(partial.pass.has_value());
+	CPPTEST_EXPECT_EQ(partial.pass->GetResolvedType(bound.at(0)), tm.getRegisteredType("double"));
+
+	options = typecheck::SolveOptions{};
+	options.deadline = std::chrono::steady_clock::now();
+	CPPTEST_EXPECT_THAT(tm.solve(options).status == typecheck::SolveStatus::TimedOut);
+	options.deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+	options.maxNodes = needed;
+	CPPTEST_EXPECT_THAT(tm.solve(options).status == typecheck::SolveStatus::Solved);
+
+	// A group with no solution is reported as such, even when the budget runs out.
+	tm.CreateBindToConstraint(bound.at(0), tm.getRegisteredType("void"));
+	options.maxNodes = 1;
+	const auto unsat = tm.solve(options, &stats);
+	CPPTEST_EXPECT_THAT(unsat.status == typecheck::SolveStatus::Unsatisfiable);
+	CPPTEST_EXPECT_FALSE(unsat.pass.has_value());
+	CPPTEST_EXPECT_FALSE(stats.failedComponents.empty());
+}
+
+NEW_TEST(ConstraintTest, CancelledSolveStopsSearching) {
+	getDefaultTypeManager(tm);
+	const auto fHash = tm.CreateFunctionHash("f", {"_"});
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("float")}, tm.getRegisteredType("double"));
+	const auto T = CreateMultipleSymbols(tm, 3);
+	tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+	tm.CreateBindFunctionConstraint(fHash, T.at(1), {T.at(0)}, T.at(2));
+
+	typecheck::CancellationToken token;
+	typecheck::SolveOptions options;
+	options.cancellation = token;
+	options.partialResult = true;
+	CPPTEST_EXPECT_THAT(tm.solve(options).status == typecheck::SolveStatus::Solved);
+	CPPTEST_EXPECT_FALSE(token.isCancelled());
+
+	// The options hold a copy, which sees the cancel too.
+	token.cancel();
+	CPPTEST_EXPECT_TRUE(options.cancellation->isCancelled());
+	typecheck::SolveStats stats;
+	const auto cancelled = tm.solve(options, &stats);
+	CPPTEST_EXPECT_THAT(cancelled.status == typecheck::SolveStatus::Cancelled);
+	CPPTEST_EXPECT_FALSE(cancelled.pass.has_value());
+	CPPTEST_EXPECT_EQ(stats.nodes, 0);
+
+	tm.setSolveThreads(2);
+	tm.setPortfolioSolve(true);
+	CPPTEST_EXPECT_THAT(tm.solve(options).status == typecheck::SolveStatus::Cancelled);
+}
+
+NEW_TEST(ConstraintTest, AsyncSolveMatchesBlocking) {
+	getDefaultTypeManager(tm);
+	const auto fHash = tm.CreateFunctionHash("f", {"_"});
+	tm.CreateApplicableFunctionConstraint(fHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+	const auto T = CreateMultipleSymbols(tm, 3);
+	tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+	tm.CreateBindFunctionConstraint(fHash, T.at(1), {T.at(0)}, T.at(2));
+	const auto expected = tm.solve();
+	CPPTEST_ASSERT_THAT(expected.has_value());
+
+	auto onThread = tm.solveAsync();
+	auto result = onThread.get();
+	CPPTEST_EXPECT_THAT(result.status == typecheck::SolveStatus::Solved);
+	CPPTEST_ASSERT_THAT(result.pass.has_value());
+	CPPTEST_EXPECT_EQ(result.pass->GetResolvedType(T.at(2)), expected->GetResolvedType(T.at(2)));
+
+	typecheck::ThreadPool executor(1);
+	result = tm.solveAsync({}, &executor).get();
+	CPPTEST_ASSERT_THAT(result.pass.has_value());
+	CPPTEST_EXPECT_EQ(result.pass->GetResolvedType(T.at(0)), expected->GetResolvedType(T.at(0)));
+
+	// The callback runs on the executor, before the future is ready.
+	std::optional<typecheck::Type> resolved;
+	auto done = tm.solveAsync({}, [&resolved, &T](typecheck::SolveResult solved) {
+		if (solved.pass.has_value()) {
+			resolved = solved.pass->GetResolvedType(T.at(2));
+		}
+	}, &executor);
+	done.get();
+	CPPTEST_ASSERT_THAT(resolved.has_value());
+	CPPTEST_EXPECT_EQ(*resolved, tm.getRegisteredType("float"));
+}
+
+NEW_TEST(ConstraintTest, IncrementalSolveOnlySearchesWhatChanged) {
+	getDefaultTypeManager(tm);
+	getDefaultTypeManager(fresh);
+	const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+	for (auto* manager : {&tm, &fresh}) {
+		manager->CreateApplicableFunctionConstraint(fooHash, {manager->getRegisteredType("int")}, manager->getRegisteredType("double"));
+		manager->CreateApplicableFunctionConstraint(fooHash, {manager->getRegisteredType("float")}, manager->getRegisteredType("int"));
+	}
+	tm.setIncrementalSolve(true);
+	CPPTEST_EXPECT_TRUE(tm.isIncrementalSolve());
+
+	// foo(a: <literal>), one independent statement each.
+	auto addCall = [fooHash](typecheck::TypeManager& manager, const bool isFloat) {
+		const auto T = CreateMultipleSymbols(manager, 3);
+		manager.CreateLiteralConformsToConstraint(T.at(1), isFloat ? typecheck::KnownProtocolKind::ExpressibleByFloat : typecheck::KnownProtocolKind::ExpressibleByInteger);
+		manager.CreateBindFunctionConstraint(fooHash, T.at(0), {T.at(1)}, T.at(2));
+		return T;
+	};
+
+	constexpr std::size_t numCalls = 8;
+	std::vector<std::vector<typecheck::TypeVar>> calls;
+	for (std::size_t i = 0; i < numCalls; ++i) {
+		calls.push_back(addCall(tm, i % 2 == 0));
+		addCall(fresh, i % 2 == 0);
+	}
+	typecheck::SolveStats stats;
+	CPPTEST_ASSERT_THAT(tm.solve(&stats).has_value());
+	CPPTEST_EXPECT_EQ(stats.reusedComponents, 0);
+	CPPTEST_EXPECT_TRUE(stats.searched);
+
+	// Nothing changed, so nothing is searched again.
+	CPPTEST_ASSERT_THAT(tm.solve(&stats).has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+	const auto reusedBefore = stats.reusedComponents;
+	CPPTEST_EXPECT_TRUE(reusedBefore > 0);
+
+	// The edit adds one statement, every other one keeps its result.
+	const auto edited = addCall(tm, false);
+	const auto expected = addCall(fresh, false);
+	const auto solution = tm.solve(&stats);
+	const auto fromScratch = fresh.solve();
+	CPPTEST_ASSERT_THAT(solution.has_value() && fromScratch.has_value());
+	CPPTEST_EXPECT_TRUE(stats.searched);
+	CPPTEST_EXPECT_EQ(stats.reusedComponents, reusedBefore);
+	for (std::size_t i = 0; i < edited.size(); ++i) {
+		CPPTEST_EXPECT_EQ(solution->GetResolvedType(edited.at(i)), fromScratch->GetResolvedType(expected.at(i)));
+	}
+
+	// A constraint added to one statement only settles that statement again, here without
+	// a search.
+	tm.CreateBindToConstraint(calls.at(1).at(2), tm.getRegisteredType("double"));
+	const auto narrowed = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(narrowed.has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+	CPPTEST_EXPECT_EQ(stats.reusedComponents, reusedBefore);
+	CPPTEST_EXPECT_EQ(narrowed->GetResolvedType(calls.at(1).at(1)), tm.getRegisteredType("int"));
+
+	// An overload only searches the statements calling its function again.
+	const auto barHash = tm.CreateFunctionHash("bar", {"a"});
+	tm.CreateApplicableFunctionConstraint(barHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("int"));
+	CPPTEST_ASSERT_THAT(tm.solve(&stats).has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+	CPPTEST_EXPECT_EQ(stats.reusedComponents, reusedBefore);
+	for (auto* manager : {&tm, &fresh}) {
+		manager->CreateApplicableFunctionConstraint(fooHash, {manager->getRegisteredType("double")}, manager->getRegisteredType("void"));
+	}
+	const auto overloaded = tm.solve(&stats);
+	const auto overloadedFromScratch = fresh.solve();
+	CPPTEST_ASSERT_THAT(overloaded.has_value() && overloadedFromScratch.has_value());
+	CPPTEST_EXPECT_TRUE(stats.searched);
+	for (std::size_t i = 0; i < edited.size(); ++i) {
+		CPPTEST_EXPECT_EQ(overloaded->GetResolvedType(edited.at(i)), overloadedFromScratch->GetResolvedType(expected.at(i)));
+	}
+
+	// Conversions can change any result, so nothing is reused after one.
+	tm.setConvertible("double", "float");
+	CPPTEST_ASSERT_THAT(tm.solve(&stats).has_value());
+	CPPTEST_EXPECT_EQ(stats.reusedComponents, 0);
+}
+
+NEW_TEST(ConstraintTest, IncrementalSolveKeepsUnrestrictedGroupsAcrossOverloads) {
+	getDefaultTypeManager(tm);
+	tm.setIncrementalSolve(true);
+
+	// A conversion between two vars nothing else mentions narrows neither before the search.
+	const auto T = CreateMultipleSymbols(tm, 2);
+	tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+	typecheck::SolveStats stats;
+	const auto before = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(before.has_value());
+	CPPTEST_EXPECT_TRUE(stats.searched);
+
+	// An overload no statement calls leaves it cached.
+	const auto barHash = tm.CreateFunctionHash("bar", {"a"});
+	tm.CreateApplicableFunctionConstraint(barHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("int"));
+	const auto after = tm.solve(&stats);
+	CPPTEST_ASSERT_THAT(after.has_value());
+	CPPTEST_EXPECT_FALSE(stats.searched);
+	CPPTEST_EXPECT_EQ(stats.reusedComponents, 1);
+	CPPTEST_EXPECT_EQ(after->GetResolvedType(T.at(1)), before->GetResolvedType(T.at(1)));
+}
+
+NEW_TEST(ConstraintTest, SolveLeavesManagerUnchanged) {
+	getDefaultTypeManager(tm);
+	const auto T = CreateMultipleSymbols(tm, 4);
+
+	// The arrays are equal before they are known to be arrays, so only the solve can tell
+	// that their elements are equal too.
+	tm.CreateEqualsConstraint(T.at(0), T.at(1));
+	tm.CreateArrayElementConstraint(T.at(0), T.at(2));
+	tm.CreateArrayElementConstraint(T.at(1), T.at(3));
+	tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("int"));
+	const auto numConstraints = tm.getConstraints().size();
+
+	const auto& manager = tm;
+	const auto first = manager.solve();
+	const auto second = manager.solve();
+	CPPTEST_ASSERT_THAT(first.has_value() && second.has_value());
+	CPPTEST_EXPECT_EQ(tm.getConstraints().size(), numConstraints);
+	CPPTEST_EXPECT_EQ(tm.getConstraintStore().size(), numConstraints);
+	CPPTEST_EXPECT_EQ(first->GetResolvedType(T.at(3)), tm.getRegisteredType("int"));
+	for (const auto& var : T) {
+		CPPTEST_EXPECT_EQ(second->GetResolvedType(var), first->GetResolvedType(var));
+	}
+}
+
+NEW_TEST(ConstraintTest, ConcurrentSolvesAgree) {
+	getDefaultTypeManager(tm);
+	std::vector<typecheck::TypeVar> T;
+	for (std::size_t i = 0; i < 16; ++i) {
+		// let a = <literal>; let b: float = a
+		const auto vars = CreateMultipleSymbols(tm, 2);
+		tm.CreateLiteralConformsToConstraint(vars.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+		tm.CreateBindToConstraint(vars.at(1), tm.getRegisteredType("float"));
+		tm.CreateConvertibleConstraint(vars.at(0), vars.at(1));
+		T.insert(T.end(), vars.begin(), vars.end());
+	}
+	tm.setIncrementalSolve(true);
+
+	// Every thread finds the conversion matrix stale and the cache empty.
+	const auto& manager = tm;
+	std::vector<std::optional<typecheck::ConstraintPass>> results(4);
+	std::vector<std::thread> threads;
+	for (auto& result : results) {
+		threads.emplace_back([&manager, &result]() { result = manager.solve(); });
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	const auto expected = manager.solve();
+	CPPTEST_ASSERT_THAT(expected.has_value());
+	for (const auto& result : results) {
+		CPPTEST_ASSERT_THAT(result.has_value());
+		for (const auto& var : T) {
+			CPPTEST_EXPECT_EQ(result->GetResolvedType(var), expected->GetResolvedType(var));
+		}
+	}
+}
+
+NEW_TEST(ConstraintTest, LiteralOnlyTakesRegisteredTypes) {
+	typecheck::TypeManager tm;
+	CPPTEST_EXPECT_THAT(tm.registerType("int"));
+
+	// float is interned by the bind, but never registered.
+	typecheck::Type floatType;
+	floatType.mutable_generic()->set_name("float");
+	const auto T = CreateMultipleSymbols(tm, 2);
+	tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+	tm.CreateBindToConstraint(T.at(1), floatType);
+	const auto solution = tm.solve();
+	CPPTEST_ASSERT_THAT(solution.has_value());
+	CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(0)), tm.getRegisteredType("int"));
+
+	tm.CreateEqualsConstraint(T.at(0), T.at(1));
+	CPPTEST_EXPECT_FALSE(tm.solve().has_value());
+}
+
 // ArrayElement constraint tests
 NEW_TEST(ConstraintTest, SolveSimpleArrayConstraint) {
     getDefaultTypeManager(tm);
@@ -0,0 +1,66 @@
+#include "typecheck/ConvertibilityMatrix.hpp"
+#include "typecheck/Debug.hpp"
+
+void typecheck::ConvertibilityMatrix::reset(const std::size_t size) {
+	this->_size = size;
+	this->_words = (size + wordBits - 1) / wordBits;
+	this->_to.assign(size * this->_words, 0);
+	this->_from.assign(size * this->_words, 0);
+}
+
+void typecheck::ConvertibilityMatrix::set(const std::size_t from, const std::size_t to) {
+	TYPECHECK_ASSERT(from < this->_size && to < this->_size, "Conversion outside the matrix.");
+	this->_to.at(from * this->_words + to / wordBits) |= Word{1} << (to % wordBits);
+	this->_from.at(to * this->_words + from / wordBits) |= Word{1} << (from % wordBits);
+}
+
+void typecheck::ConvertibilityMatrix::close() {
+	// Warshall's algorithm, a whole row at a time.
+	for (std::size_t k = 0; k < this->_size; ++k) {
+		const auto* through = this->_to.data() + k * this->_words;
+		for (std::size_t i = 0; i < this->_size; ++i) {
+			if (i == k || !this->converts(i, k)) {
+				continue;
+			}
+			auto* row = this->_to.data() + i * this->_words;
+			for (std::size_t w = 0; w < this->_words; ++w) {
+				row[w] |= through[w];
+			}
+		}
+	}
+
+	// Rebuild the transpose from the closed rows.
+	this->_from.assign(this->_size * this->_words, 0);
+	for (std::size_t i = 0; i < this->_size; ++i) {
+		for (std::size_t j = 0; j < this->_size; ++j) {
+			if (this->converts(i, j)) {
+				this->_from.at(j * this->_words + i / wordBits) |= Word{1} << (i % wordBits);
+			}
+		}
+	}
+}
+
+auto typecheck::ConvertibilityMatrix::converts(const std::size_t from, const std::size_t to) const noexcept -> bool {
+	if (from >= this->_size || to >= this->_size) {
+		return false;
+	}
+	return (this->_to[from * this->_words + to / wordBits] >> (to % wordBits)) & 1U;
+}
+
+auto typecheck::ConvertibilityMatrix::to(const std::size_t from) const -> std::span<const Word> {
+	TYPECHECK_ASSERT(from < this->_size, "Type outside the matrix.");
+	return std::span<const Word>(this->_to).subspan(from * this->_words, this->_words);
+}
+
+auto typecheck::ConvertibilityMatrix::from(const std::size_t to) const -> std::span<const Word> {
+	TYPECHECK_ASSERT(to < this->_size, "Type outside the matrix.");
+	return std::span<const Word>(this->_from).subspan(to * this->_words, this->_words);
+}
+
+auto typecheck::ConvertibilityMatrix::size() const noexcept -> std::size_t {
+	return this->_size;
+}
+
+auto typecheck::ConvertibilityMatrix::words() const noexcept -> std::size_t {
+	return this->_words;
+}
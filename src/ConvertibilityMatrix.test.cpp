@@ -0,0 +1,55 @@
+#include "cpptest/cpptest.hpp"
+#include "typecheck/ConvertibilityMatrix.hpp"
+
+class ConvertibilityMatrixTest : public cpptest::BaseCppTest {
+public:
+    void SetUp() {
+        // Run before every test
+    }
+
+    void TearDown() {
+        // Run After every test
+    }
+};
+
+CPPTEST_CLASS(ConvertibilityMatrixTest)
+
+NEW_TEST(ConvertibilityMatrixTest, SetIsDirected) {
+    typecheck::ConvertibilityMatrix matrix;
+    matrix.reset(3);
+    matrix.set(0, 2);
+
+    CPPTEST_EXPECT_TRUE(matrix.converts(0, 2));
+    CPPTEST_EXPECT_FALSE(matrix.converts(2, 0));
+    CPPTEST_EXPECT_FALSE(matrix.converts(0, 1));
+    CPPTEST_EXPECT_EQ(matrix.to(0).front(), 4);
+    CPPTEST_EXPECT_EQ(matrix.from(2).front(), 1);
+}
+
+NEW_TEST(ConvertibilityMatrixTest, CloseAcrossWords) {
+    constexpr std::size_t size = 200;
+    typecheck::ConvertibilityMatrix matrix;
+    matrix.reset(size);
+    for (std::size_t i = 1; i < size; ++i) {
+        matrix.set(i - 1, i);
+    }
+    CPPTEST_EXPECT_EQ(matrix.words(), 4);
+    CPPTEST_EXPECT_FALSE(matrix.converts(0, size - 1));
+
+    matrix.close();
+    CPPTEST_EXPECT_TRUE(matrix.converts(0, size - 1));
+    CPPTEST_EXPECT_TRUE(matrix.converts(70, 130));
+    CPPTEST_EXPECT_FALSE(matrix.converts(130, 70));
+    CPPTEST_EXPECT_FALSE(matrix.converts(5, 5));
+    CPPTEST_EXPECT_EQ(matrix.from(size - 1).front(), ~typecheck::ConvertibilityMatrix::Word{0});
+}
+
+NEW_TEST(ConvertibilityMatrixTest, OutOfRangeNeverConverts) {
+    typecheck::ConvertibilityMatrix matrix;
+    matrix.reset(2);
+    matrix.set(0, 1);
+    CPPTEST_EXPECT_FALSE(matrix.converts(typecheck::ConvertibilityMatrix::npos, 1));
+    CPPTEST_EXPECT_FALSE(matrix.converts(0, 2));
+}
+
+CPPTEST_END_CLASS(ConvertibilityMatrixTest)
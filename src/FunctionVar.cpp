@@ -5,6 +5,16 @@
 
 #include <sstream>
 
+namespace {
+    // Inverse of TypeVar::symbol(), "T4" -> TypeVar(4)
+    auto TypeVarFromSymbol(const std::string& symbol) -> typecheck::TypeVar {
+        if (symbol.size() < 2 || symbol.front() != 'T') {
+            return typecheck::TypeVar{};
+        }
+        return typecheck::TypeVar(static_cast<typecheck::TypeVar::IDType>(std::stoul(symbol.substr(1))));
+    }
+}
+
 typecheck::FunctionVar::FunctionVar() : _id(0) {}
 
 auto typecheck::FunctionVar::name() const -> std::string {
@@ -47,7 +57,7 @@ auto typecheck::FunctionVar::serialize() const -> std::string {
         }
     }
     ss << "|";
-    ss << (this->_returnVar.symbol().empty() ? "<empty>" : this->_returnVar.symbol());
+    ss << (this->_returnVar.empty() ? "<empty>" : this->_returnVar.symbol());
     ss << "|";
     ss << (this->_name.empty() ? "<empty>" : this->_name);
     ss << "|";
@@ -66,9 +76,9 @@ auto typecheck::FunctionVar::unserialize(const std::string& str) -> FunctionVar
 
     FunctionVar f;
     for (const auto& a : args) {
-        f._args.emplace_back(a);
+        f._args.emplace_back(TypeVarFromSymbol(a));
     }
-    f._returnVar = (returnVar == "<empty>" ? "" : returnVar);
+    f._returnVar = TypeVarFromSymbol(returnVar);
     f._name = (name == "<empty>" ? "" : name);
     f._id = id;
 
@@ -4,6 +4,14 @@ auto typecheck::GenericTypeGenerator::next_id() -> long long {
 	return this->curr_num++;
 }
 
+auto typecheck::GenericTypeGenerator::peek_id() const noexcept -> long long {
+	return this->curr_num;
+}
+
+void typecheck::GenericTypeGenerator::rewind(const long long id) noexcept {
+	this->curr_num = id;
+}
+
 auto typecheck::GenericTypeGenerator::next() -> std::string {
     return "T" + std::to_string(this->next_id());
 }
@@ -0,0 +1,139 @@
+#include "typecheck/ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+typecheck::ThreadPool::ThreadPool(std::size_t threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (std::size_t i = 0; i < threads; ++i) {
+		this->queues.push_back(std::make_unique<Queue>());
+	}
+	for (std::size_t i = 0; i < threads; ++i) {
+		this->workers.emplace_back([this, i]() { this->work(i); });
+	}
+}
+
+typecheck::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(this->sleepMutex);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	for (auto& worker : this->workers) {
+		worker.join();
+	}
+}
+
+auto typecheck::ThreadPool::size() const noexcept -> std::size_t {
+	return this->workers.size();
+}
+
+void typecheck::ThreadPool::post(Task task) {
+	const auto index = this->nextQueue.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+	{
+		auto& queue = *this->queues.at(index);
+		std::lock_guard lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard lock(this->sleepMutex);
+		++this->pending;
+	}
+	this->wake.notify_one();
+}
+
+auto typecheck::ThreadPool::pop(const std::size_t index, Task& task) -> bool {
+	{
+		auto& own = *this->queues.at(index);
+		std::lock_guard lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	for (std::size_t i = 1; i < this->queues.size(); ++i) {
+		auto& other = *this->queues.at((index + i) % this->queues.size());
+		std::lock_guard lock(other.mutex);
+		if (!other.tasks.empty()) {
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void typecheck::ThreadPool::work(const std::size_t index) {
+	while (true) {
+		{
+			std::unique_lock lock(this->sleepMutex);
+			this->wake.wait(lock, [this]() { return this->stopping || this->pending > 0; });
+			if (this->pending == 0) {
+				return;
+			}
+			// Claims one queued task, which some queue is guaranteed to hold.
+			--this->pending;
+		}
+
+		Task task;
+		while (!this->pop(index, task)) {
+			std::this_thread::yield();
+		}
+		task();
+	}
+}
+
+void typecheck::ThreadPool::parallelFor(const std::size_t count, const std::function<void(std::size_t)>& body) {
+	if (count == 0) {
+		return;
+	}
+
+	// Shared with the helper tasks, which may only start after every index is taken.
+	struct State {
+		std::function<void(std::size_t)> body;
+		std::size_t count = 0;
+		std::atomic<std::size_t> next = 0;
+		std::atomic<std::size_t> done = 0;
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::exception_ptr error;
+	};
+	auto state = std::make_shared<State>();
+	state->body = body;
+	state->count = count;
+
+	auto run = [](const std::shared_ptr<State>& shared) {
+		for (auto i = shared->next++; i < shared->count; i = shared->next++) {
+			try {
+				shared->body(i);
+			} catch (...) {
+				std::lock_guard lock(shared->mutex);
+				if (!shared->error) {
+					shared->error = std::current_exception();
+				}
+			}
+
+			if (++shared->done == shared->count) {
+				std::lock_guard lock(shared->mutex);
+				shared->finished.notify_all();
+			}
+		}
+	};
+
+	const auto helpers = std::min(count - 1, this->size());
+	for (std::size_t i = 0; i < helpers; ++i) {
+		this->post([state, run]() { run(state); });
+	}
+	run(state);
+
+	std::unique_lock lock(state->mutex);
+	state->finished.wait(lock, [&state]() { return state->done == state->count; });
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
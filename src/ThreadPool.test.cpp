@@ -0,0 +1,49 @@
+#include "cpptest/cpptest.hpp"
+#include "typecheck/ThreadPool.hpp"
+
+#include <atomic>
+#include <vector>
+
+class ThreadPoolTest : public cpptest::BaseCppTest {
+public:
+    void SetUp() {
+        // Run before every test
+    }
+
+    void TearDown() {
+        // Run After every test
+    }
+};
+
+CPPTEST_CLASS(ThreadPoolTest)
+
+NEW_TEST(ThreadPoolTest, SubmitReturnsResult) {
+    typecheck::ThreadPool pool(2);
+    CPPTEST_EXPECT_EQ(pool.size(), 2);
+
+    auto future = pool.submit([]() { return 42; });
+    CPPTEST_EXPECT_EQ(future.get(), 42);
+}
+
+NEW_TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    typecheck::ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallelFor(visits.size(), [&visits](const std::size_t i) { ++visits.at(i); });
+    for (const auto& count : visits) {
+        CPPTEST_EXPECT_EQ(count.load(), 1);
+    }
+}
+
+NEW_TEST(ThreadPoolTest, NestedParallelForFinishes) {
+    typecheck::ThreadPool pool(2);
+    std::atomic<int> total = 0;
+
+    // Every worker blocks in an inner loop, which must still make progress.
+    pool.parallelFor(8, [&pool, &total](const std::size_t) {
+        pool.parallelFor(8, [&total](const std::size_t) { ++total; });
+    });
+    CPPTEST_EXPECT_EQ(total.load(), 64);
+}
+
+CPPTEST_END_CLASS(ThreadPoolTest)
@@ -33,25 +33,23 @@ namespace {
 auto TypeManager::CreateEqualsConstraint(const TypeVar& t0, const TypeVar& t1) -> Constraint::IDType {
 	auto constraint = getNewBlankConstraint(ConstraintKind::Equal, this->constraint_generator.next_id());
 
-	TYPECHECK_ASSERT(!t0.symbol().empty(), "Cannot use empty type when creating constraint.");
-	TYPECHECK_ASSERT(!t1.symbol().empty(), "Cannot use empty type when creating constraint.");
+	TYPECHECK_ASSERT(!t0.empty(), "Cannot use empty type when creating constraint.");
+	TYPECHECK_ASSERT(!t1.empty(), "Cannot use empty type when creating constraint.");
 
-	TYPECHECK_ASSERT(this->registeredTypeVars.find(t0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
-	TYPECHECK_ASSERT(this->registeredTypeVars.find(t1.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+	TYPECHECK_ASSERT(this->hasTypeVar(t0), "Must create type var before using.");
+	TYPECHECK_ASSERT(this->hasTypeVar(t1), "Must create type var before using.");
 
 	constraint.mutable_types()->mutable_first()->CopyFrom(t0);
 	constraint.mutable_types()->mutable_second()->CopyFrom(t1);
 
 	// If both type variables are arrays, also create an Equals constraint between their element types
-	auto t0ElementIt = this->arrayElementMap.find(t0.symbol());
-	auto t1ElementIt = this->arrayElementMap.find(t1.symbol());
+	auto t0ElementIt = this->arrayElementMap.find(t0);
+	auto t1ElementIt = this->arrayElementMap.find(t1);
 	
 	if (t0ElementIt != this->arrayElementMap.end() && t1ElementIt != this->arrayElementMap.end()) {
 		// Both are arrays, create element equality
-		TypeVar t0Element;
-		t0Element.set_symbol(t0ElementIt->second);
-		TypeVar t1Element;
-		t1Element.set_symbol(t1ElementIt->second);
+		const auto& t0Element = t0ElementIt->second;
+		const auto& t1Element = t1ElementIt->second;
 		
 		// Recursively create equals constraint for elements
 		// Note: We need to add this constraint first, then add the main constraint
@@ -63,22 +61,22 @@ auto TypeManager::CreateEqualsConstraint(const TypeVar& t0, const TypeVar& t1) -
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
 		std::cout << "Auto-generated element equality: " << debug_constraint_headers(elementConstraint) << std::endl;
 #endif
-		this->constraints.emplace_back(elementConstraint);
+		this->addConstraint(elementConstraint);
+		this->derivedConstraints.emplace(constraint.id(), elementConstraint.id());
 	}
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
     std::cout << debug_constraint_headers(constraint) << std::endl;
 #endif
 
-	this->constraints.emplace_back(constraint);
-	return constraint.id();
+	return this->addConstraint(constraint);
 }
 
 auto TypeManager::CreateLiteralConformsToConstraint(const TypeVar& t0, const KnownProtocolKind::LiteralProtocol& protocol) -> Constraint::IDType {
 	auto constraint = getNewBlankConstraint(ConstraintKind::ConformsTo, this->constraint_generator.next_id());
 
-	TYPECHECK_ASSERT(!t0.symbol().empty(), "Cannot use empty type when creating constraint.");
-	TYPECHECK_ASSERT(this->registeredTypeVars.find(t0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+	TYPECHECK_ASSERT(!t0.empty(), "Cannot use empty type when creating constraint.");
+	TYPECHECK_ASSERT(this->hasTypeVar(t0), "Must create type var before using.");
 
 	constraint.mutable_conforms()->mutable_type()->CopyFrom(t0);
 	constraint.mutable_conforms()->mutable_protocol()->set_literal(protocol);
@@ -88,18 +86,17 @@ auto TypeManager::CreateLiteralConformsToConstraint(const TypeVar& t0, const Kno
     std::cout << debug_constraint_headers(constraint) << std::endl;
 #endif
 
-	this->constraints.emplace_back(constraint);
-	return constraint.id();
+	return this->addConstraint(constraint);
 }
 
 auto TypeManager::CreateConvertibleConstraint(const TypeVar& T0, const TypeVar& T1) -> Constraint::IDType {
     auto constraint = getNewBlankConstraint(ConstraintKind::Conversion, this->constraint_generator.next_id());
 
-    TYPECHECK_ASSERT(!T0.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(!T0.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T0), "Must create type var before using.");
 
-    TYPECHECK_ASSERT(!T1.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T1.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(!T1.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T1), "Must create type var before using.");
 
     constraint.mutable_types()->mutable_first()->CopyFrom(T0);
     constraint.mutable_types()->mutable_second()->CopyFrom(T1);
@@ -108,8 +105,7 @@ auto TypeManager::CreateConvertibleConstraint(const TypeVar& T0, const TypeVar&
     std::cout << debug_constraint_headers(constraint) << std::endl;
 #endif
 
-    this->constraints.emplace_back(constraint);
-    return constraint.id();
+    return this->addConstraint(constraint);
 }
 
 auto TypeManager::CreateApplicableFunctionConstraint(const Constraint::IDType& functionid, const std::vector<Type>& args, const Type& return_type) -> Constraint::IDType {
@@ -143,41 +139,45 @@ auto TypeManager::CreateApplicableFunctionConstraint(const Constraint::IDType& f
 auto TypeManager::CreateApplicableFunctionConstraint(const Constraint::IDType& functionid, const FunctionVar& type) -> Constraint::IDType {
     TYPECHECK_ASSERT(type.id() == functionid, "Function type ID should match function id and be set.");
 
-    this->functions.push_back(type);
+    auto& family = this->functions[functionid];
+    if (family.empty()) {
+        this->functionOrder.push_back(functionid);
+    }
+    family.push_back(type);
+    this->overloadLog.push_back(functionid);
     return type.id();
 }
 
 auto TypeManager::CreateBindFunctionConstraint(const Constraint::IDType& functionid, const TypeVar& T0, const std::vector<TypeVar>& args, const TypeVar& returnType) -> Constraint::IDType {
     auto constraint = getNewBlankConstraint(ConstraintKind::BindOverload, this->constraint_generator.next_id());
 
-    TYPECHECK_ASSERT(!T0.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(!T0.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T0), "Must create type var before using.");
     constraint.mutable_overload()->mutable_type()->CopyFrom(T0);
     constraint.mutable_overload()->set_functionid(functionid);
 
     for (const auto& arg : args) {
-        TYPECHECK_ASSERT(!arg.symbol().empty(), "Cannot use empty type when creating constraint.");
-        TYPECHECK_ASSERT(this->registeredTypeVars.find(arg.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+        TYPECHECK_ASSERT(!arg.empty(), "Cannot use empty type when creating constraint.");
+        TYPECHECK_ASSERT(this->hasTypeVar(arg), "Must create type var before using.");
         constraint.mutable_overload()->add_argvars()->CopyFrom(arg);
     }
 
-    TYPECHECK_ASSERT(!returnType.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(returnType.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(!returnType.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(returnType), "Must create type var before using.");
     constraint.mutable_overload()->mutable_returnvar()->CopyFrom(returnType);
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
     std::cout << debug_constraint_headers(constraint) << std::endl;
 #endif
 
-    this->constraints.emplace_back(constraint);
-    return constraint.id();
+    return this->addConstraint(constraint);
 }
 
 auto TypeManager::CreateBindToConstraint(const TypeVar& T0, const Type& type) -> Constraint::IDType {
     auto constraint = getNewBlankConstraint(ConstraintKind::Bind, this->constraint_generator.next_id());
 
-    TYPECHECK_ASSERT(!T0.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(!T0.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T0), "Must create type var before using.");
     TYPECHECK_ASSERT(type.has_generic() || type.has_func(), "Must insert valid type.");
 
     constraint.mutable_explicit()->mutable_var()->CopyFrom(T0);
@@ -187,28 +187,28 @@ auto TypeManager::CreateBindToConstraint(const TypeVar& T0, const Type& type) ->
     std::cout << debug_constraint_headers(constraint) << std::endl;
 #endif
 
-    this->constraints.emplace_back(constraint);
-    return constraint.id();
+    return this->addConstraint(constraint);
 }
 
 auto TypeManager::CreateArrayElementConstraint(const TypeVar& arrayVar, const TypeVar& elementVar) -> Constraint::IDType {
     auto constraint = getNewBlankConstraint(ConstraintKind::ArrayElement, this->constraint_generator.next_id());
 
-    TYPECHECK_ASSERT(!arrayVar.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(arrayVar.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
-    TYPECHECK_ASSERT(!elementVar.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(elementVar.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(!arrayVar.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(arrayVar), "Must create type var before using.");
+    TYPECHECK_ASSERT(!elementVar.empty(), "Cannot use empty type when creating constraint.");
+    TYPECHECK_ASSERT(this->hasTypeVar(elementVar), "Must create type var before using.");
 
     constraint.mutable_types()->mutable_first()->CopyFrom(arrayVar);
     constraint.mutable_types()->mutable_second()->CopyFrom(elementVar);
 
     // Track the array-element relationship
-    this->arrayElementMap[arrayVar.symbol()] = elementVar.symbol();
+    auto [it, inserted] = this->arrayElementMap.try_emplace(arrayVar, elementVar);
+    this->arrayElementLog.emplace_back(arrayVar, inserted ? std::nullopt : std::optional<TypeVar>(it->second));
+    it->second = elementVar;
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
     std::cout << debug_constraint_headers(constraint) << std::endl;
 #endif
 
-    this->constraints.emplace_back(constraint);
-    return constraint.id();
+    return this->addConstraint(constraint);
 }
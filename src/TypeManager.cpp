@@ -6,6 +6,8 @@
 #include "typecheck/protocols/ExpressibleByDoubleLiteral.hpp"
 #include "typecheck/protocols/ExpressibleByFloatLiteral.hpp"
 #include "typecheck/protocols/ExpressibleByIntegerLiteral.hpp"
+#include "ValueSet.hpp"
+#include "ValueTable.hpp"
 
 #include "constraint/Domain.hpp"
 #include "constraint/Env.hpp"
@@ -16,10 +18,19 @@
 
 #include "cppnotstdlib/strings.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cassert>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <limits>                                     // for numeric_limits
 #include <list>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <sstream>                                    // for std::stringstream
@@ -28,7 +39,30 @@
 #include <type_traits>                                // for move
 #include <utility>                                    // for make_pair
 
+// Search results of the last solve's components, see `setIncrementalSolve`.
+struct typecheck::TypeManager::SolveCache {
+    struct Result {
+        bool solved = false;
+        std::vector<std::pair<TypeVar::IDType, ValueTable::IDType>> assigned;
+        std::size_t generation = 0; // Last solve that used it
+    };
+
+    explicit SolveCache(const TypeTable& table) : types(table), values(std::in_place, table) {}
+
+    void clear() {
+        this->values.emplace(this->types);
+        this->results.clear();
+    }
+
+    const TypeTable& types;
+    std::optional<ValueTable> values; // Shared by every solve, so cached value IDs keep their meaning
+    std::map<std::vector<std::uint64_t>, Result> results; // By component key
+    std::size_t generation = 0;
+    std::mutex mutex; // Held for a whole solve, which updates all of the above
+};
+
 typecheck::TypeManager::TypeManager() = default;
+typecheck::TypeManager::~TypeManager() = default;
 
 auto typecheck::TypeManager::registerType(const std::string& name) -> bool {
     Type ty;
@@ -37,24 +71,42 @@ auto typecheck::TypeManager::registerType(const std::string& name) -> bool {
 }
 
 auto typecheck::TypeManager::registerType(const Type& name) -> bool {
+	if (!name.has_generic() && !name.has_func()) {
+		return false;
+	}
+
+	const auto id = this->typeTable.intern(name);
+	if (id >= this->registeredTypeIndex.size()) {
+		this->registeredTypeIndex.resize(this->typeTable.size(), false);
+	}
+
 	// Determine if has type
-	const auto alreadyHasType = this->hasRegisteredType(name);
-	if (!alreadyHasType) {
-		Type type;
-		type.CopyFrom(name);
-		this->registeredTypes.emplace_back(type);
+	if (this->registeredTypeIndex.at(id)) {
+		return false;
 	}
-	return !alreadyHasType;
+
+	this->registeredTypeIndex.at(id) = true;
+	this->registeredTypes.emplace_back(id);
+	this->conversionMatrixStale = true;
+	this->invalidateSolveCache();
+	this->pinnedTypes = std::max(this->pinnedTypes, static_cast<std::size_t>(id) + 1);
+	return true;
+}
+
+auto typecheck::TypeManager::findRegisteredType(const Type& name) const noexcept -> TypeTable::IDType {
+	const auto id = this->typeTable.find(name);
+	if (id == TypeTable::npos || id >= this->registeredTypeIndex.size() || !this->registeredTypeIndex.at(id)) {
+		return TypeTable::npos;
+	}
+	return id;
 }
 
 auto typecheck::TypeManager::hasRegisteredType(const std::string& name) const noexcept -> bool {
-    const auto returned = this->getRegisteredType(name);
-    return returned.has_generic() || returned.has_func();
+    return this->findRegisteredType(Type(GenericType(name))) != TypeTable::npos;
 }
 
 auto typecheck::TypeManager::hasRegisteredType(const Type& name) const noexcept -> bool {
-    const auto returned = this->getRegisteredType(name);
-    return returned.has_generic() || returned.has_func();
+    return this->findRegisteredType(name) != TypeTable::npos;
 }
 
 auto typecheck::TypeManager::getRegisteredType(const std::string& name) const noexcept -> Type {
@@ -64,27 +116,40 @@ auto typecheck::TypeManager::getRegisteredType(const std::string& name) const no
 }
 
 auto typecheck::TypeManager::getRegisteredType(const Type& name) const noexcept -> Type {
-	for (const auto& type : this->registeredTypes) {
-        if (type == name) {
-			return type;
-		}
+	const auto id = this->findRegisteredType(name);
+	if (id == TypeTable::npos) {
+		return {};
 	}
 
-	return {};
+	return this->typeTable.get(id);
 }
 
-auto typecheck::TypeManager::getFunctionOverloads(Constraint::IDType funcID) const -> std::vector<FunctionVar> {
-    std::vector<FunctionVar> overloads;
-    for (const auto& overload : this->functions) {
-        // Lookup by 'var', to deal with anonymous functions.
-        if (overload.id() == funcID) {
-            // Copy it over, and hand it over a 'function definition'.
+auto typecheck::TypeManager::getTypeTable() const noexcept -> const TypeTable& {
+	return this->typeTable;
+}
 
-            overloads.push_back(overload);
-        }
+auto typecheck::TypeManager::getConstraintStore() const noexcept -> const ConstraintStore& {
+	return this->store;
+}
+
+auto typecheck::TypeManager::getConstraints() const noexcept -> std::span<const Constraint> {
+	return this->constraints;
+}
+
+auto typecheck::TypeManager::getFunctionOverloads(Constraint::IDType funcID) const -> std::span<const FunctionVar> {
+    // Lookup by 'id', to deal with anonymous functions.
+    const auto it = this->functions.find(funcID);
+    if (it == this->functions.end()) {
+        return {};
     }
 
-    return overloads;
+    return it->second;
+}
+
+auto typecheck::TypeManager::getFunctionOverload(const OverloadKey& key) const -> const FunctionVar& {
+    const auto family = this->getFunctionOverloads(key.functionID);
+    TYPECHECK_ASSERT(key.index < family.size(), "Unknown function overload.");
+    return family[key.index];
 }
 
 auto typecheck::TypeManager::setConvertible(const std::string& T0, const std::string& T1) -> bool {
@@ -116,21 +181,77 @@ auto typecheck::TypeManager::setConvertible(const Type& T0, const Type& T1) -> b
 		return true;
 	}
 
-	const auto& t0_ptr = this->getRegisteredType(T0);
-	const auto& t1_ptr = this->getRegisteredType(T1);
+	const auto t0_id = this->findRegisteredType(T0);
+	const auto t1_id = this->findRegisteredType(T1);
+	if (t0_id == TypeTable::npos || t1_id == TypeTable::npos) {
+		return false;
+	}
 
     // Function types not convertible
-    if (t0_ptr.has_func() || t1_ptr.has_func()) {
+    if (this->typeTable.has_func(t0_id) || this->typeTable.has_func(t1_id)) {
         // Functions not convertible to each other
         return false;
-    } else if (!t0_ptr.generic().name().empty() && !t1_ptr.generic().name().empty() && this->convertible[t0_ptr.generic().name()].find(t1_ptr.generic().name()) == this->convertible[t0_ptr.generic().name()].end()) {
+    }
+
+	const auto& t0_name = this->typeTable.name(t0_id);
+	const auto& t1_name = this->typeTable.name(t1_id);
+	if (!t0_name.empty() && !t1_name.empty()) {
 		// Convertible from T0 -> T1
-        this->convertible[t0_ptr.generic().name()].insert(t1_ptr.generic().name());
-		return true;
+		const auto inserted = this->convertible[t0_name].insert(t1_name).second;
+		if (inserted) {
+			this->conversionMatrixStale = true;
+			this->invalidateSolveCache();
+		}
+		return inserted;
 	}
 	return false;
 }
 
+void typecheck::TypeManager::setConvertibleTransitive(const bool transitive) {
+    if (this->transitiveConversions != transitive) {
+        this->transitiveConversions = transitive;
+        this->conversionMatrixStale = true;
+        this->invalidateSolveCache();
+    }
+}
+
+void typecheck::TypeManager::buildConversionMatrix() const {
+    // Concurrent solves may all find it stale, the first one rebuilds it.
+    std::lock_guard lock(this->conversionMatrixMutex);
+    if (!this->conversionMatrixStale) {
+        return;
+    }
+
+    // Registration index of each type, by TypeTable ID.
+    std::vector<std::size_t> index(this->typeTable.size(), ConvertibilityMatrix::npos);
+    for (std::size_t i = 0; i < this->registeredTypes.size(); ++i) {
+        index.at(this->registeredTypes.at(i)) = i;
+    }
+    auto indexOf = [this, &index](const std::string& name) {
+        const auto id = this->typeTable.find(Type(GenericType(name)));
+        return id == TypeTable::npos ? ConvertibilityMatrix::npos : index.at(id);
+    };
+
+    this->conversionMatrix.reset(this->registeredTypes.size());
+    for (const auto& [from, tos] : this->convertible) {
+        const auto fromIndex = indexOf(from);
+        if (fromIndex == ConvertibilityMatrix::npos) {
+            continue;
+        }
+        for (const auto& to : tos) {
+            const auto toIndex = indexOf(to);
+            if (toIndex != ConvertibilityMatrix::npos) {
+                this->conversionMatrix.set(fromIndex, toIndex);
+            }
+        }
+    }
+
+    if (this->transitiveConversions) {
+        this->conversionMatrix.close();
+    }
+    this->conversionMatrixStale = false;
+}
+
 auto typecheck::TypeManager::isConvertible(const std::string& T0, const std::string& T1) const noexcept -> bool {
     Type t0;
     t0.mutable_generic()->set_name(T0);
@@ -189,115 +310,595 @@ auto typecheck::TypeManager::getConvertible(const Type& T0) const -> std::vector
 }
 
 auto typecheck::TypeManager::CreateTypeVar() -> const TypeVar {
-	const auto var = this->type_generator.next();
+	TYPECHECK_ASSERT(this->numTypeVars < TypeVar::npos, "Exhausted type variable handles.");
+	return TypeVar(this->numTypeVars++);
+}
+
+auto typecheck::TypeManager::hasTypeVar(const TypeVar& var) const noexcept -> bool {
+	return var.id() < this->numTypeVars;
+}
 
-	this->registeredTypeVars.insert(var);
+auto typecheck::TypeManager::addConstraint(const Constraint& constraint) -> Constraint::IDType {
+    const auto id = constraint.id();
+    TYPECHECK_ASSERT(id >= 0, "Constraint IDs come from the constraint generator.");
 
-	TypeVar type;
-	type.set_symbol(var);
-	return type;
+    const auto slot = static_cast<std::size_t>(id);
+    if (slot >= this->constraintSlots.size()) {
+        this->constraintSlots.resize(slot + 1, std::numeric_limits<std::size_t>::max());
+    }
+    this->constraintSlots.at(slot) = this->constraints.size();
+    this->constraints.emplace_back(constraint);
+    this->store.add(constraint, this->typeTable);
+    return id;
 }
 
-auto typecheck::TypeManager::getConstraintInternal(const Constraint::IDType id) -> Constraint* {
-    for (auto& constraint : this->constraints) {
-        if (constraint.id() == id) {
-            return &constraint;
+auto typecheck::TypeManager::removeConstraint(const Constraint::IDType id) -> bool {
+    return this->removeConstraints(std::span(&id, 1)) != 0;
+}
+
+auto typecheck::TypeManager::removeConstraints(const std::span<const Constraint::IDType> ids) -> std::size_t {
+    TYPECHECK_ASSERT(this->scopes.empty(), "Cannot remove constraints inside a scope.");
+    std::vector<Constraint::IDType> removed;
+    for (const auto id : ids) {
+        if (this->getConstraint(id) == nullptr) {
+            continue;
         }
+        removed.push_back(id);
+
+        const auto derived = this->derivedConstraints.find(id);
+        if (derived != this->derivedConstraints.end()) {
+            if (this->getConstraint(derived->second) != nullptr) {
+                removed.push_back(derived->second);
+            }
+            this->derivedConstraints.erase(derived);
+        }
+    }
+    std::sort(removed.begin(), removed.end());
+    removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+    if (removed.empty()) {
+        return 0;
     }
 
-    return nullptr;
+    auto isRemoved = [&removed](const Constraint::IDType id) {
+        return std::binary_search(removed.begin(), removed.end(), id);
+    };
+
+    // Close the gaps in `constraints`, moving the slots of what shifts down.
+    std::vector<bool> arraysChanged(this->numTypeVars, false);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < this->constraints.size(); ++i) {
+        const auto id = this->constraints[i].id();
+        const auto slot = static_cast<std::size_t>(id);
+        if (isRemoved(id)) {
+            if (this->constraints[i].kind() == ConstraintKind::ArrayElement) {
+                arraysChanged.at(this->constraints[i].types().first().id()) = true;
+            }
+            this->constraintSlots.at(slot) = std::numeric_limits<std::size_t>::max();
+            continue;
+        }
+
+        if (kept != i) {
+            this->constraints[kept] = std::move(this->constraints[i]);
+        }
+        this->constraintSlots.at(slot) = kept++;
+    }
+    this->constraints.resize(kept);
+    this->store.remove(removed);
+    ++this->removals;
+
+    // An array's element is the one from its latest remaining ArrayElement, if any.
+    std::erase_if(this->arrayElementMap, [&arraysChanged](const auto& entry) {
+        return arraysChanged.at(entry.first.id());
+    });
+    for (const auto& arrayElement : this->store.arrayElements()) {
+        if (arraysChanged.at(arrayElement.first.id())) {
+            this->arrayElementMap.insert_or_assign(arrayElement.first, arrayElement.second);
+        }
+    }
+
+    return removed.size();
 }
 
-auto typecheck::TypeManager::getConstraint(const Constraint::IDType id) const -> const Constraint* {
-	for (const auto& constraint : this->constraints) {
-		if (constraint.id() == id) {
-			return &constraint;
-		}
-	}
+auto typecheck::TypeManager::mark() const noexcept -> Mark {
+    return Mark{
+        this->numTypeVars,
+        this->constraints.size(),
+        this->constraint_generator.peek_id(),
+        this->store.mark(),
+        this->typeTable.size(),
+        this->overloadLog.size(),
+        this->arrayElementLog.size(),
+        this->removals,
+    };
+}
+
+void typecheck::TypeManager::resetToMark(const Mark& mark) {
+    TYPECHECK_ASSERT(mark.numTypeVars <= this->numTypeVars &&
+        mark.numConstraints <= this->constraints.size() &&
+        mark.nextConstraintID <= this->constraint_generator.peek_id() &&
+        mark.numOverloads <= this->overloadLog.size() &&
+        mark.numArrayElements <= this->arrayElementLog.size(), "Mark is newer than the type manager.");
+    // Removal compacts the constraints without logging it, so older sizes mean nothing.
+    TYPECHECK_ASSERT(mark.removals == this->removals, "Constraints were removed since the mark was taken.");
+
+    // Undo in reverse, so overwritten entries come back in the right order.
+    while (this->arrayElementLog.size() > mark.numArrayElements) {
+        const auto& [arrayVar, previous] = this->arrayElementLog.back();
+        if (previous.has_value()) {
+            this->arrayElementMap[arrayVar] = *previous;
+        } else {
+            this->arrayElementMap.erase(arrayVar);
+        }
+        this->arrayElementLog.pop_back();
+    }
 
-	return nullptr;
+    while (this->overloadLog.size() > mark.numOverloads) {
+        const auto funcID = this->overloadLog.back();
+        auto& family = this->functions.at(funcID);
+        family.pop_back();
+        if (family.empty()) {
+            // Families are created on their first overload, so this one is last in order.
+            this->functions.erase(funcID);
+            this->functionOrder.pop_back();
+        }
+        this->overloadLog.pop_back();
+    }
+
+    // Only the constraints being dropped can have generated an element equality.
+    for (auto i = mark.numConstraints; i < this->constraints.size(); ++i) {
+        this->derivedConstraints.erase(this->constraints.at(i).id());
+    }
+    this->constraints.resize(mark.numConstraints);
+    this->store.truncate(mark.store);
+    const auto nextID = static_cast<std::size_t>(mark.nextConstraintID);
+    if (this->constraintSlots.size() > nextID) {
+        this->constraintSlots.resize(nextID);
+    }
+    this->constraint_generator.rewind(mark.nextConstraintID);
+    this->numTypeVars = mark.numTypeVars;
+
+    // Types registered since the mark are kept, along with everything they refer to.
+    const auto numTypes = std::max(mark.numTypes, this->pinnedTypes);
+    this->typeTable.truncate(numTypes);
+    if (this->registeredTypeIndex.size() > numTypes) {
+        this->registeredTypeIndex.resize(numTypes);
+    }
+    this->invalidateSolveCache();
+}
+
+void typecheck::TypeManager::pushScope() {
+    this->scopes.push_back(this->mark());
+}
+
+void typecheck::TypeManager::popScope() {
+    TYPECHECK_ASSERT(!this->scopes.empty(), "No scope to pop.");
+    this->resetToMark(this->scopes.back());
+    this->scopes.pop_back();
+}
+
+void typecheck::TypeManager::commitScope() {
+    TYPECHECK_ASSERT(!this->scopes.empty(), "No scope to commit.");
+    this->scopes.pop_back();
+}
+
+auto typecheck::TypeManager::scopeDepth() const noexcept -> std::size_t {
+    return this->scopes.size();
+}
+
+auto typecheck::TypeManager::getConstraintInternal(const Constraint::IDType id) -> Constraint* {
+    return const_cast<Constraint*>(std::as_const(*this).getConstraint(id));
+}
+
+auto typecheck::TypeManager::getConstraint(const Constraint::IDType id) const -> const Constraint* {
+    // IDs are dense, so the slot table is indexed by ID directly.
+    if (id < 0 || static_cast<std::size_t>(id) >= this->constraintSlots.size()) {
+        return nullptr;
+    }
+    const auto slot = this->constraintSlots.at(static_cast<std::size_t>(id));
+    if (slot >= this->constraints.size() || this->constraints.at(slot).id() != id) {
+        return nullptr; // Removed, or never created
+    }
+    return &this->constraints.at(slot);
 }
 
 namespace {
-    typecheck::Type TypeFromString(const std::string& val, const constraint::Solution& sol) {
-        // Check if it's an array type: "Array[elementType]"
-        if (val.rfind("Array[", 0) == 0 && val.back() == ']') {
-            // Extract element type from "Array[elementType]"
-            const auto elementTypeName = val.substr(6, val.size() - 7);  // Skip "Array[" and "]"
+    // Disjoint sets of type var IDs, union by size with path compression.
+    class TypeVarClasses {
+    public:
+        explicit TypeVarClasses(const std::size_t size) : parent(size), sizes(size, 1) {
+            std::iota(parent.begin(), parent.end(), typecheck::TypeVar::IDType{0});
+        }
+
+        auto find(typecheck::TypeVar::IDType id) -> typecheck::TypeVar::IDType {
+            auto root = id;
+            while (this->parent.at(root) != root) {
+                root = this->parent.at(root);
+            }
+            while (this->parent.at(id) != root) {
+                id = std::exchange(this->parent.at(id), root);
+            }
+            return root;
+        }
+
+        void unite(const typecheck::TypeVar::IDType a, const typecheck::TypeVar::IDType b) {
+            auto rootA = this->find(a);
+            auto rootB = this->find(b);
+            if (rootA == rootB) {
+                return;
+            }
+            if (this->sizes.at(rootA) < this->sizes.at(rootB)) {
+                std::swap(rootA, rootB);
+            }
+            this->parent.at(rootB) = rootA;
+            this->sizes.at(rootA) += this->sizes.at(rootB);
+        }
+
+    private:
+        std::vector<typecheck::TypeVar::IDType> parent;
+        std::vector<std::size_t> sizes;
+    };
+
+    // Builds the type a solver value stands for, function signatures are resolved through `valueOf` each var.
+    template<typename ValueFunc, typename OverloadFunc>
+    auto TypeFromValue(const typecheck::ValueTable& values, const typecheck::ValueTable::IDType id, const typecheck::TypeTable& types, const ValueFunc& valueOf, const OverloadFunc& overloadOf) -> typecheck::Type {
+        switch (values.kind(id)) {
+        case typecheck::ValueTable::Kind::Type:
+            return types.get(values.typeID(id));
+        case typecheck::ValueTable::Kind::Array: {
             typecheck::GenericType arrayType("Array");
-            arrayType.add_type_param()->CopyFrom(TypeFromString(elementTypeName, sol));
+            arrayType.add_type_param()->CopyFrom(TypeFromValue(values, values.element(id), types, valueOf, overloadOf));
             return {arrayType};
         }
-        
-        if (cppnotstdlib::string::explode(val, '|').size() == 1) {
-            return {typecheck::GenericType(val)};
-        } else {
-            const auto fvar = typecheck::FunctionVar::unserialize(val);
-            typecheck::FunctionDefinition funcDef;
-            funcDef.set_name(fvar.name());
-            funcDef.set_id(fvar.id());
+        case typecheck::ValueTable::Kind::Function:
+        default:
+            break;
+        }
 
-            const auto returnVar = fvar.returnvar().symbol();
-            const auto lookupReturnVar = sol.At(returnVar).to_string();
+        const auto& fvar = overloadOf(values.overload(id));
+        typecheck::FunctionDefinition funcDef;
+        funcDef.set_name(fvar.name());
+        funcDef.set_id(fvar.id());
 
-            // A function should not return itself.
-            // Prevent infinite loops
-            assert(returnVar != val);
-            assert(lookupReturnVar != val);
+        auto resolve = [&](const typecheck::TypeVar& var) {
+            // A function should not return or take itself, prevent infinite loops.
+            const auto resolved = valueOf(var);
+            if (resolved == typecheck::ValueTable::npos || resolved == id) {
+                throw std::logic_error("Unresolvable function signature");
+            }
+            return TypeFromValue(values, resolved, types, valueOf, overloadOf);
+        };
 
-            funcDef.mutable_returntype()->CopyFrom(TypeFromString(lookupReturnVar, sol));
-            for (const auto& a : fvar.args()) {
-                const auto foundVariable = a.symbol(); 
-                const auto resolvedVariable = sol.At(foundVariable).to_string();
+        funcDef.mutable_returntype()->CopyFrom(resolve(fvar.returnvar()));
+        for (const auto& a : fvar.args()) {
+            funcDef.add_args()->CopyFrom(resolve(a));
+        }
+        return {funcDef};
+    }
+
+    // A two-var constraint the propagation stage understands.
+    struct BinaryConstraint {
+        typecheck::ConstraintKind kind;
+        typecheck::TypeVar::IDType first;
+        typecheck::TypeVar::IDType second;
+    };
 
-                // Prevent infinite loops.
-                assert(foundVariable != val);
+    using ValueDomain = typecheck::ValueSet;
 
-                if (!sol.Contains(foundVariable)) {
-                    throw std::logic_error("Solution does not contain variable");
+    // A constraint left for the search, over the solver variables of `vars`.
+    struct SearchConstraint {
+        typecheck::Constraint::IDType source = 0; // The constraint it was made from
+        std::vector<typecheck::TypeVar::IDType> vars;
+        std::vector<std::string> names;
+        std::function<bool(const constraint::Env&)> check;
+        bool propagated = false; // Already enforced by the propagation stage
+    };
+
+    // Solver variables linked by search constraints, searched on their own.
+    struct Component {
+        std::vector<typecheck::TypeVar> vars;
+        std::vector<typecheck::TypeVar> shared; // Fixed vars of other components its constraints read
+        std::vector<std::size_t> constraints;
+        std::vector<std::size_t> heuristics;
+    };
+
+    // The order a search hands a component's vars to the solver. A portfolio solve races
+    // one search per order, the others only run when it's enabled.
+    enum class SearchOrder : std::uint8_t {
+        Given, // As the constraints first mentioned them
+        FewestValuesFirst,
+        CallsFirst, // Overload choices before anything else
+        LiteralsFirst,
+    };
+    constexpr std::array<SearchOrder, 4> searchOrders{SearchOrder::Given, SearchOrder::FewestValuesFirst, SearchOrder::CallsFirst, SearchOrder::LiteralsFirst};
+
+    // Thrown out of a search the portfolio no longer needs, or that ran out of budget.
+    struct SearchStopped {};
+
+    // The node and time limits and the cancellation token of one solve, or of one of the
+    // `shares` searches of a portfolio solve, which split the nodes evenly, rounded up so
+    // each gets at least one. Searches check it from their heuristic, which the solver
+    // calls once per expansion.
+    class SearchBudget {
+    public:
+        explicit SearchBudget(const typecheck::SolveOptions& options, const std::size_t shares = 1) : maxNodes(options.maxNodes == 0 ? std::nullopt : std::optional((options.maxNodes + shares - 1) / shares)), deadline(options.deadline), cancellation(options.cancellation) {}
+
+        // Counts one expansion, false once the budget is spent or the solve cancelled.
+        auto expand() -> bool {
+            const auto count = ++this->nodes;
+            if (this->maxNodes.has_value() && count > *this->maxNodes) {
+                this->spent.store(true, std::memory_order_relaxed);
+            } else if (count == 1 || count % pollInterval == 0) {
+                if (this->deadline.has_value() && std::chrono::steady_clock::now() >= *this->deadline) {
+                    this->spent.store(true, std::memory_order_relaxed);
                 }
+                static_cast<void>(this->poll());
+            }
+            return !this->spent.load(std::memory_order_relaxed) && !this->cancelled.load(std::memory_order_relaxed);
+        }
 
-                const auto foundType = TypeFromString(resolvedVariable, sol);
-                funcDef.add_args()->CopyFrom(foundType);
+        // Reads the cancellation token, true once it was cancelled.
+        auto poll() -> bool {
+            if (this->cancellation.has_value() && this->cancellation->isCancelled()) {
+                this->cancelled.store(true, std::memory_order_relaxed);
             }
-            return {funcDef};
+            return this->cancelled.load(std::memory_order_relaxed);
         }
-    }
 
-    void AddTypeToDomain(constraint::Domain::data_type& domain, const typecheck::Type& type) {
-        if (type.has_generic()) {
-            domain.emplace_back(type.generic().name());
-        } else if (type.has_func()) {
-            domain.emplace_back(type.func().name());
+        [[nodiscard]] auto wasCancelled() const -> bool {
+            return this->cancelled.load(std::memory_order_relaxed);
+        }
+
+        // Expansions made within the budget.
+        [[nodiscard]] auto expanded() const -> std::size_t {
+            const auto count = this->nodes.load(std::memory_order_relaxed);
+            return this->maxNodes.has_value() ? std::min(count, *this->maxNodes) : count;
+        }
+
+    private:
+        static constexpr std::size_t pollInterval = 64; // Expansions between reads of the clock and token
+
+        std::optional<std::size_t> maxNodes; // Unlimited when empty
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        std::optional<typecheck::CancellationToken> cancellation;
+        std::atomic<std::size_t> nodes = 0;
+        std::atomic<bool> spent = false;
+        std::atomic<bool> cancelled = false;
+    };
+
+    // AC-3 over Conversion and ArrayElement constraints. A var without a domain has
+    // `fullDomain`. Returns the number of values removed.
+    auto PruneDomains(std::vector<std::optional<ValueDomain>>& domains, const ValueDomain& fullDomain, const std::vector<BinaryConstraint>& binary, const typecheck::ValueTable& values, const typecheck::ConvertibilityMatrix& matrix, const std::vector<std::size_t>& matrixIndex) -> std::size_t {
+        auto domainOf = [&](const typecheck::TypeVar::IDType var) -> const ValueDomain& {
+            const auto& domain = domains.at(var);
+            return domain.has_value() ? *domain : fullDomain;
+        };
+        auto contains = [](const ValueDomain& domain, const typecheck::ValueTable::IDType value) {
+            return domain.contains(value);
+        };
+        auto indexOf = [&matrixIndex](const typecheck::ValueTable::IDType value) {
+            return value < matrixIndex.size() ? matrixIndex.at(value) : typecheck::ConvertibilityMatrix::npos;
+        };
+        // The domain as a bitset over the matrix's types.
+        auto toBits = [&](const ValueDomain& domain) {
+            std::vector<typecheck::ConvertibilityMatrix::Word> bits(matrix.words(), 0);
+            for (const auto value : domain) {
+                const auto index = indexOf(value);
+                if (index != typecheck::ConvertibilityMatrix::npos) {
+                    bits.at(index / typecheck::ConvertibilityMatrix::wordBits) |= typecheck::ConvertibilityMatrix::Word{1} << (index % typecheck::ConvertibilityMatrix::wordBits);
+                }
+            }
+            return bits;
+        };
+        auto intersects = [](const std::span<const typecheck::ConvertibilityMatrix::Word> row, const std::vector<typecheck::ConvertibilityMatrix::Word>& bits) {
+            for (std::size_t w = 0; w < bits.size(); ++w) {
+                if ((row[w] & bits[w]) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // Keeps the values of `var` that have a support in the other side of constraint `c`.
+        auto revise = [&](const std::size_t c, const bool reviseFirst) -> std::size_t {
+            const auto& constraint = binary.at(c);
+            const auto var = reviseFirst ? constraint.first : constraint.second;
+            const auto& other = domainOf(reviseFirst ? constraint.second : constraint.first);
+
+            std::vector<typecheck::ConvertibilityMatrix::Word> otherBits;
+            if (constraint.kind == typecheck::ConstraintKind::Conversion) {
+                otherBits = toBits(other);
+            }
+
+            ValueDomain kept;
+            for (const auto value : domainOf(var)) {
+                bool supported = false;
+                if (constraint.kind == typecheck::ConstraintKind::Conversion) {
+                    const auto index = indexOf(value);
+                    supported = contains(other, value) || (index != typecheck::ConvertibilityMatrix::npos && intersects(reviseFirst ? matrix.to(index) : matrix.from(index), otherBits));
+                } else if (reviseFirst) {
+                    // Array side, its element must be a possible element.
+                    supported = values.kind(value) == typecheck::ValueTable::Kind::Array && contains(other, values.element(value));
+                } else {
+                    // Element side, its array must be a possible array.
+                    const auto array = values.find_array(value);
+                    supported = array != typecheck::ValueTable::npos && contains(other, array);
+                }
+
+                if (supported) {
+                    kept.insert(value);
+                }
+            }
+
+            const auto removed = domainOf(var).size() - kept.size();
+            if (removed != 0) {
+                domains.at(var) = std::move(kept);
+            }
+            return removed;
+        };
+
+        // Arc 2c revises the first var of constraint c, 2c + 1 the second.
+        std::vector<std::vector<std::size_t>> constraintsOf(domains.size());
+        for (std::size_t c = 0; c < binary.size(); ++c) {
+            constraintsOf.at(binary.at(c).first).push_back(c);
+            constraintsOf.at(binary.at(c).second).push_back(c);
+        }
+
+        std::deque<std::size_t> queue;
+        std::vector<bool> queued(binary.size() * 2, true);
+        for (std::size_t arc = 0; arc < binary.size() * 2; ++arc) {
+            queue.push_back(arc);
+        }
+
+        std::size_t removed = 0;
+        while (!queue.empty()) {
+            const auto arc = queue.front();
+            queue.pop_front();
+            queued.at(arc) = false;
+
+            const auto c = arc / 2;
+            const auto reviseFirst = arc % 2 == 0;
+            const auto count = revise(c, reviseFirst);
+            if (count == 0) {
+                continue;
+            }
+
+            removed += count;
+            const auto var = reviseFirst ? binary.at(c).first : binary.at(c).second;
+            if (domainOf(var).empty()) {
+                break;
+            }
+
+            // Everything constrained by `var` has to be checked against its smaller domain.
+            for (const auto other : constraintsOf.at(var)) {
+                for (const auto otherArc : {other * 2, other * 2 + 1}) {
+                    const auto& otherConstraint = binary.at(other);
+                    const auto revised = otherArc % 2 == 0 ? otherConstraint.first : otherConstraint.second;
+                    if ((revised != var || otherConstraint.first == otherConstraint.second) && !queued.at(otherArc)) {
+                        queued.at(otherArc) = true;
+                        queue.push_back(otherArc);
+                    }
+                }
+            }
         }
-    }
 
-    void AddTypeToDomain(constraint::Domain::data_type& domain, const typecheck::FunctionVar& type) {
-        domain.emplace_back(type.serialize());
+        return removed;
     }
 
-    using distance_type = std::function<std::size_t(const constraint::State&)>;
+    // A call to an overloaded function, its [return, args...] against each overload's.
+    struct OverloadCall {
+        typecheck::TypeVar::IDType type;
+        std::vector<typecheck::TypeVar::IDType> vars;
+        std::vector<typecheck::ValueTable::IDType> functions; // Value of each overload
+        std::vector<std::vector<typecheck::TypeVar::IDType>> definitions; // Empty when the arg count differs
+        std::vector<std::size_t> constraints; // Search constraints checking the call
+    };
 
-    template<typename T>
-    void AddLiteralProtocolTypes(constraint::Domain::data_type& domain) {
-        T protocol;
-        for (const auto& ty : protocol.getPreferredTypes()) {
-            AddTypeToDomain(domain, ty);
+    // Drops the overloads a call can't take, narrows its vars to what the remaining ones
+    // accept, and marks the call's constraints as enforced once everything is fixed.
+    auto PropagateOverloads(std::vector<std::optional<ValueDomain>>& domains, const ValueDomain& fullDomain, const std::vector<OverloadCall>& calls, std::vector<SearchConstraint>& constraints) -> std::size_t {
+        auto domainOf = [&](const typecheck::TypeVar::IDType var) -> const ValueDomain& {
+            const auto& domain = domains.at(var);
+            return domain.has_value() ? *domain : fullDomain;
+        };
+
+        std::size_t removed = 0;
+        auto narrow = [&](const typecheck::TypeVar::IDType var, const ValueDomain& domain) {
+            const auto before = domainOf(var).size();
+            auto kept = domainOf(var);
+            kept &= domain;
+            const auto after = kept.size();
+            if (after != before) {
+                removed += before - after;
+                domains.at(var) = std::move(kept);
+            }
+        };
+
+        for (const auto& call : calls) {
+            // Overloads whose every var could still equal the call's.
+            std::vector<std::size_t> viable;
+            for (std::size_t i = 0; i < call.functions.size(); ++i) {
+                const auto& definition = call.definitions.at(i);
+                if (definition.size() != call.vars.size() || !domainOf(call.type).contains(call.functions.at(i))) {
+                    continue;
+                }
+
+                bool matches = true;
+                for (std::size_t j = 0; j < call.vars.size() && matches; ++j) {
+                    matches = domainOf(call.vars.at(j)).intersects(domainOf(definition.at(j)));
+                }
+                if (matches) {
+                    viable.push_back(i);
+                }
+            }
+
+            ValueDomain functions;
+            for (const auto i : viable) {
+                functions.insert(call.functions.at(i));
+            }
+            narrow(call.type, functions);
+
+            for (std::size_t j = 0; j < call.vars.size(); ++j) {
+                ValueDomain accepted;
+                for (const auto i : viable) {
+                    accepted |= domainOf(call.definitions.at(i).at(j));
+                }
+                narrow(call.vars.at(j), accepted);
+            }
+
+            if (viable.size() != 1) {
+                continue;
+            }
+
+            // The overload is known, so its vars equal the call's.
+            const auto& definition = call.definitions.at(viable.front());
+            bool fixed = true;
+            for (std::size_t j = 0; j < call.vars.size(); ++j) {
+                narrow(definition.at(j), domainOf(call.vars.at(j)));
+                fixed = fixed && domainOf(call.vars.at(j)).size() == 1 && domainOf(definition.at(j)).size() == 1;
+            }
+            if (fixed) {
+                for (const auto c : call.constraints) {
+                    constraints.at(c).propagated = true;
+                }
+            }
         }
 
-        for (const auto& ty : protocol.getOtherTypes()) {
-            AddTypeToDomain(domain, ty);
+        return removed;
+    }
+
+    // Solver values of the interned types in `types`, types never interned can't be assigned anyway.
+    void AddTypesToDomain(std::vector<typecheck::ValueTable::IDType>& domain, const std::vector<typecheck::Type>& types, typecheck::ValueTable& values, const typecheck::TypeTable& table) {
+        for (const auto& ty : types) {
+            const auto id = table.find(ty);
+            if (id != typecheck::TypeTable::npos) {
+                domain.push_back(values.type(id));
+            }
         }
     }
 
     template<typename T>
-    void AddHeuristicProtocolFuncs(std::vector<constraint::Solver::DistanceFunc>& heuristics, std::vector<constraint::Solver::DistanceFunc>& actuals, const std::string& var) {
-        heuristics.emplace_back([var](const constraint::StateQuery& state) {
-            T protocol;
+    void AddLiteralProtocolTypes(std::vector<typecheck::ValueTable::IDType>& domain, typecheck::ValueTable& values, const typecheck::TypeTable& table) {
+        T protocol;
+        AddTypesToDomain(domain, protocol.getPreferredTypes(), values, table);
+        AddTypesToDomain(domain, protocol.getOtherTypes(), values, table);
+    }
+
+    template<typename T>
+    void AddHeuristicProtocolFuncs(std::vector<constraint::Solver::DistanceFunc>& heuristics, std::vector<constraint::Solver::DistanceFunc>& actuals, const std::string& var, typecheck::ValueTable& values, const typecheck::TypeTable& table) {
+        T protocol;
+        std::vector<typecheck::ValueTable::IDType> preferredIDs;
+        AddTypesToDomain(preferredIDs, protocol.getPreferredTypes(), values, table);
+        constraint::Domain::data_type preferred;
+        for (const auto& id : preferredIDs) {
+            preferred.push_back(values.value(id));
+        }
+
+        heuristics.emplace_back([var, preferred](const constraint::StateQuery& state) {
             if (state.IsAssigned(var)) {
                 // Check if in preferred list or not.
-                for (const auto& ty : protocol.getPreferredTypes()) {
-                    if (ty.generic().name() == state.variable_map.at(var).to_string()) {
+                const auto assigned = state.variable_map.at(var);
+                for (const auto& ty : preferred) {
+                    if (ty == assigned) {
                         return 0;
                     }
                 }
@@ -310,12 +911,12 @@ namespace {
         });
 
         // Use the same one for the actual solution, except punish more for not assigned.
-        actuals.emplace_back([var](const constraint::StateQuery& state) {
-            T protocol;
+        actuals.emplace_back([var, preferred](const constraint::StateQuery& state) {
             if (state.IsAssigned(var)) {
                 // Check if in preferred list or not.
-                for (const auto& ty : protocol.getPreferredTypes()) {
-                    if (ty.generic().name() == state.variable_map.at(var).to_string()) {
+                const auto assigned = state.variable_map.at(var);
+                for (const auto& ty : preferred) {
+                    if (ty == assigned) {
                         return 0;
                     }
                 }
@@ -329,392 +930,933 @@ namespace {
     }
 }
 
-auto typecheck::TypeManager::solve() -> std::optional<ConstraintPass> {
-    constraint::Solver constraint_solver;
-    std::set<std::string> all_variable_names;
+void typecheck::TypeManager::setSolveThreads(const std::size_t threads) {
+    if (threads == this->getSolveThreads()) {
+        return;
+    }
+    this->solvePool = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+}
+
+auto typecheck::TypeManager::getSolveThreads() const noexcept -> std::size_t {
+    return this->solvePool != nullptr ? this->solvePool->size() : 1;
+}
+
+void typecheck::TypeManager::setIncrementalSolve(const bool incremental) {
+    if (!incremental) {
+        this->solveCache.reset();
+    } else if (this->solveCache == nullptr) {
+        this->solveCache = std::make_unique<SolveCache>(this->typeTable);
+    }
+}
+
+auto typecheck::TypeManager::isIncrementalSolve() const noexcept -> bool {
+    return this->solveCache != nullptr;
+}
+
+void typecheck::TypeManager::setPortfolioSolve(const bool portfolio) {
+    this->portfolioSolve = portfolio;
+}
+
+auto typecheck::TypeManager::isPortfolioSolve() const noexcept -> bool {
+    return this->portfolioSolve;
+}
+
+void typecheck::TypeManager::invalidateSolveCache() {
+    if (this->solveCache != nullptr) {
+        this->solveCache->clear();
+    }
+}
+
+auto typecheck::TypeManager::solve() const -> std::optional<ConstraintPass> {
+    return this->solve(nullptr);
+}
+
+auto typecheck::TypeManager::solve(SolveStats* stats) const -> std::optional<ConstraintPass> {
+    // Without limits a solve can't time out, no pass means unsatisfiable.
+    auto result = this->solve(SolveOptions{}, stats);
+    return std::move(result.pass);
+}
+
+auto typecheck::TypeManager::solveAsync(const SolveOptions& options, ThreadPool* executor) const -> std::future<SolveResult> {
+    auto task = [this, options]() {
+        return this->solve(options);
+    };
+    if (executor != nullptr) {
+        return executor->submit(std::move(task));
+    }
+    return std::async(std::launch::async, std::move(task));
+}
+
+auto typecheck::TypeManager::solveAsync(const SolveOptions& options, std::function<void(SolveResult)> done, ThreadPool* executor) const -> std::future<void> {
+    auto task = [this, options, done = std::move(done)]() {
+        done(this->solve(options));
+    };
+    if (executor != nullptr) {
+        return executor->submit(std::move(task));
+    }
+    return std::async(std::launch::async, std::move(task));
+}
+
+auto typecheck::TypeManager::solve(const SolveOptions& options, SolveStats* stats) const -> SolveResult {
+    SolveStats localStats;
+    if (stats == nullptr) {
+        stats = &localStats;
+    }
+    *stats = SolveStats{};
+
+    std::unique_lock<std::mutex> cacheLock;
+    if (this->solveCache != nullptr) {
+        cacheLock = std::unique_lock(this->solveCache->mutex);
+    }
+
+    // Equal vars always share a type, so each class of them is one solver variable.
+    TypeVarClasses classes(this->numTypeVars);
+    for (const auto& equal : this->store.equals()) {
+        classes.unite(equal.first.id(), equal.second.id());
+    }
+
+    // Equal arrays have equal elements. Merging two element classes can make more arrays
+    // equal (nested arrays), so repeat until nothing merges. Nothing is added to the manager.
+    std::vector<TypeVar::IDType> elementOf(this->numTypeVars);
+    for (bool merged = !this->store.arrayElements().empty(); merged;) {
+        merged = false;
+        std::fill(elementOf.begin(), elementOf.end(), this->numTypeVars);
+        for (const auto& arrayElement : this->store.arrayElements()) {
+            auto& element = elementOf.at(classes.find(arrayElement.first.id()));
+            if (element == this->numTypeVars) {
+                element = arrayElement.second.id();
+            } else if (classes.find(element) != classes.find(arrayElement.second.id())) {
+                classes.unite(element, arrayElement.second.id());
+                merged = true;
+            }
+        }
+    }
+    auto rep = [&classes](const TypeVar& var) {
+        return TypeVar(classes.find(var.id()));
+    };
+
+    // The solver is keyed by name, so build each type var's name at most once per solve.
+    std::vector<std::string> varNames(this->numTypeVars);
+    auto name = [&varNames, &rep](const TypeVar& var) -> const std::string& {
+        const auto representative = rep(var);
+        auto& cached = varNames.at(representative.id());
+        if (cached.empty()) {
+            cached = representative.symbol();
+        }
+        return cached;
+    };
 
     std::vector<constraint::Solver::DistanceFunc> heuristcFuncs;
     std::vector<constraint::Solver::DistanceFunc> distanceFuncs;
+    std::vector<TypeVar::IDType> heuristicVars; // The solver variable each heuristic looks at
+    std::vector<Constraint::IDType> heuristicSources; // The constraint each heuristic was made from
+
+    // Every candidate is a value ID, the table says what each one stands for.
+    // Incremental solves share one table, the IDs in their cached results stay valid.
+    std::optional<ValueTable> localValues;
+    if (this->solveCache == nullptr) {
+        localValues.emplace(this->typeTable);
+    }
+    ValueTable& values = this->solveCache != nullptr ? *this->solveCache->values : *localValues;
+    auto toDomain = [&values](const ValueSet& ids) {
+        constraint::Domain::data_type domain;
+        domain.reserve(ids.size());
+        for (const auto& id : ids) {
+            domain.push_back(values.value(id));
+        }
+        return constraint::Domain(domain);
+    };
 
-    auto insert_if_not_exists = [&constraint_solver, &all_variable_names](const std::string& var, const constraint::Domain& domain) {
-        if (domain.size() == 0) {
-            std::cout << "Warning: Domain Empty for variable: " << var << std::endl;
+    // Solver variables are only created once every constraint has had its say on their domain.
+    std::vector<TypeVar> all_variables;
+    std::vector<bool> usedVars(this->numTypeVars, false);
+    std::vector<bool> hasVariable(this->numTypeVars, false);
+    std::vector<std::optional<ValueSet>> restrictedDomains(this->numTypeVars);
+    std::vector<SearchConstraint> solverConstraints;
+
+    auto use = [&](const TypeVar& var) {
+        usedVars.at(var.id()) = true;
+        const auto representative = rep(var);
+        if (!hasVariable.at(representative.id())) {
+            hasVariable.at(representative.id()) = true;
+            all_variables.push_back(representative);
         }
+        return representative;
+    };
 
-        if (all_variable_names.find(var) == all_variable_names.end()) {
-            constraint_solver.AddVariable(var, domain);
-            all_variable_names.insert(var);
+    // Narrows the domain of `var`'s class to `domain`. Domains are visited in value ID
+    // order, which puts registered types first, in registration order.
+    auto restrict = [&](const TypeVar& var, const std::vector<ValueTable::IDType>& domain) {
+        auto& current = restrictedDomains.at(use(var).id());
+        if (!current.has_value()) {
+            current = ValueSet(domain);
+            return;
         }
+        *current &= ValueSet(domain);
     };
 
-    // Pre-processing: Add implied element equality constraints
-    // If we have Equals(A, B) and ArrayElement(A, EA) and ArrayElement(B, EB),
-    // then add Equals(EA, EB)
-    std::vector<Constraint> impliedConstraints;
-    for (const auto& equalsConstraint : this->constraints) {
-        if (equalsConstraint.kind() == Equal && equalsConstraint.has_types()) {
-            const auto& types = equalsConstraint.types();
-            if (types.has_first() && types.has_second()) {
-                const auto& var1 = types.first().symbol();
-                const auto& var2 = types.second().symbol();
-                
-                // Check if both have array element constraints
-                auto it1 = this->arrayElementMap.find(var1);
-                auto it2 = this->arrayElementMap.find(var2);
-                
-                if (it1 != this->arrayElementMap.end() && it2 != this->arrayElementMap.end()) {
-                    // Both are arrays - add element equality constraint
-                    Constraint elemConstraint;
-                    elemConstraint.set_kind(ConstraintKind::Equal);
-                    elemConstraint.set_id(this->constraint_generator.next_id());
-                    
-                    TypeVar elem1, elem2;
-                    elem1.set_symbol(it1->second);
-                    elem2.set_symbol(it2->second);
-                    elemConstraint.mutable_types()->mutable_first()->CopyFrom(elem1);
-                    elemConstraint.mutable_types()->mutable_second()->CopyFrom(elem2);
-                    impliedConstraints.push_back(elemConstraint);
-                }
-            }
+    // Constraints the propagation stage can filter domains through.
+    std::vector<BinaryConstraint> binaryConstraints;
+    std::vector<OverloadCall> overloadCalls;
+
+    auto addConstraint = [&solverConstraints, &name, &rep](const Constraint::IDType source, const std::vector<TypeVar>& vars, std::function<bool(const constraint::Env&)> check, const bool propagated) {
+        SearchConstraint constraint;
+        constraint.source = source;
+        for (const auto& var : vars) {
+            constraint.vars.push_back(rep(var).id());
+            constraint.names.push_back(name(var));
         }
+        constraint.check = std::move(check);
+        constraint.propagated = propagated;
+        solverConstraints.push_back(std::move(constraint));
+    };
+
+    // Var Domain
+    std::vector<ValueTable::IDType> baseValues;
+    for (const auto& ty : this->registeredTypes) {
+        baseValues.push_back(values.type(ty));
     }
-    
-    // Add the implied constraints
-    for (const auto& constraint : impliedConstraints) {
-        this->constraints.push_back(constraint);
+    for (const auto& funcID : this->functionOrder) {
+        const auto numOverloads = this->functions.at(funcID).size();
+        for (std::uint32_t i = 0; i < numOverloads; ++i) {
+            baseValues.push_back(values.function(OverloadKey{funcID, i}));
+        }
     }
+    const ValueSet fullDomain(baseValues);
 
-    // Var Domain
-    const auto varDomain = [this] {
-        constraint::Domain::data_type domain;
-        for (const auto& ty : this->registeredTypes) {
-            AddTypeToDomain(domain, ty);
+    for (const auto& equal : this->store.equals()) {
+        use(equal.first);
+        use(equal.second);
+    }
+
+    if (!this->store.arrayElements().empty()) {
+        // Element gets full domain which includes both base types and array types, to support nested arrays.
+        auto elementValues = baseValues;
+        for (const auto& id : baseValues) {
+            elementValues.push_back(values.array(id));
         }
 
-        for (const auto& func : this->functions) {
-            AddTypeToDomain(domain, func);
+        // Array gets domain of Array[T] for each T in the element domain (including nested arrays)
+        std::vector<ValueTable::IDType> arrayValues;
+        for (const auto& id : elementValues) {
+            arrayValues.push_back(values.array(id));
         }
 
-        return constraint::Domain(domain);
-    }();
-
-    for (const auto& constraint : this->constraints) {
-        if (constraint.has_conforms()) {
-            const auto conforms = constraint.conforms();
-            if (conforms.has_type() && conforms.has_protocol()) {
-                const auto var = conforms.type().symbol();
-                const auto protocol = conforms.protocol();
-                constraint::Domain::data_type domain;
-                switch (protocol.literal()) {
-                case KnownProtocolKind::ExpressibleByFloat:
-                    AddLiteralProtocolTypes<ExpressibleByFloatLiteral>(domain);
-                    AddHeuristicProtocolFuncs<ExpressibleByFloatLiteral>(heuristcFuncs, distanceFuncs, var);
-                    break;
-                case KnownProtocolKind::ExpressibleByDouble:
-                    AddLiteralProtocolTypes<ExpressibleByDoubleLiteral>(domain);
-                    AddHeuristicProtocolFuncs<ExpressibleByDoubleLiteral>(heuristcFuncs, distanceFuncs, var);
-                    break;
-                case KnownProtocolKind::ExpressibleByInteger:
-                    AddLiteralProtocolTypes<ExpressibleByIntegerLiteral>(domain);
-                    AddHeuristicProtocolFuncs<ExpressibleByIntegerLiteral>(heuristcFuncs, distanceFuncs, var);
-                    break;
-				case KnownProtocolKind::ExpressibleByArray:
-				case KnownProtocolKind::ExpressibleByBoolean:
-				case KnownProtocolKind::ExpressibleByDictionary:
-				case KnownProtocolKind::ExpressibleByNil:
-				case KnownProtocolKind::ExpressibleByString:
-                default:
-                    std::cout << "Unsupported Literal" << std::endl;
-                    return std::nullopt;
-                    break;
+        for (const auto& arrayElement : this->store.arrayElements()) {
+            restrict(arrayElement.second, elementValues);
+            restrict(arrayElement.first, arrayValues);
+            binaryConstraints.push_back(BinaryConstraint{ArrayElement, rep(arrayElement.first).id(), rep(arrayElement.second).id()});
+
+            // ArrayElement constraint: arrayVar (first) is Array<elementVar (second)>
+            const std::vector<std::string> type_names{name(arrayElement.first), name(arrayElement.second)};
+            addConstraint(arrayElement.id, {arrayElement.first, arrayElement.second}, [type_names, V = &values](const constraint::Env& env) {
+                const auto arrayValue = V->decode(env.At(type_names.at(0)));
+                const auto elementValue = V->decode(env.At(type_names.at(1)));
+                if (arrayValue == ValueTable::npos || elementValue == ValueTable::npos) {
+                    return false;
                 }
-                insert_if_not_exists(var, varDomain);
-
-                // conforms literal is implied by its domain.
-                constraint_solver.AddConstraint(std::vector{var}, [var, domain](const constraint::Env& env) {
-                    for (const auto& ty : domain) {
-                        if (env.At(var) == ty) {
-                            return true;
-                        }
+
+                return V->kind(arrayValue) == ValueTable::Kind::Array && V->element(arrayValue) == elementValue;
+            }, true);
+        }
+    }
+
+    for (const auto& bind : this->store.binds()) {
+        const auto& var = bind.var;
+
+        // The domain can only the be the explicit type.
+        if (!this->typeTable.has_generic(bind.type) && !this->typeTable.has_func(bind.type)) {
+            throw std::runtime_error("Unhandled explicit type parsing");
+        }
+        restrict(var, {values.type(bind.type)});
+        if (!this->typeTable.has_generic(bind.type)) {
+            addConstraint(bind.id, {var}, [](const constraint::Env&) {
+                return false;
+            }, false);
+        }
+    }
+
+    for (const auto& overload : this->store.overloads()) {
+        std::vector<TypeVar> overloadVariables;
+        overloadVariables.emplace_back(overload.type);
+        overloadVariables.emplace_back(overload.returnVar);
+        for (const auto& arg : this->store.args(overload)) {
+            overloadVariables.emplace_back(arg);
+        }
+
+        // Gather all overloads.
+        const auto funcFamily = this->getFunctionOverloads(overload.functionID);
+        std::vector<std::vector<TypeVar>> all_func_dependant_variables;
+        std::vector<ValueTable::IDType> typeDomain;
+        for (std::uint32_t i = 0; i < funcFamily.size(); ++i) {
+            const auto& func = funcFamily[i];
+            std::vector<TypeVar> funcDependantVariables;
+            funcDependantVariables.emplace_back(func.returnvar());
+            for (const auto& arg : func.args()) {
+                funcDependantVariables.emplace_back(arg);
+            }
+
+            all_func_dependant_variables.emplace_back(funcDependantVariables);
+            typeDomain.push_back(values.function(OverloadKey{overload.functionID, i}));
+        }
+
+        restrict(overload.type, typeDomain);
+
+        OverloadCall call;
+        call.type = rep(overload.type).id();
+        for (const auto& var : std::span(overloadVariables).subspan(1)) {
+            call.vars.push_back(rep(var).id());
+        }
+        call.functions = typeDomain;
+        for (const auto& a : overloadVariables) {
+            use(a);
+        }
+        for (const auto& a : all_func_dependant_variables) {
+            for (const auto& b : a) {
+                use(b);
+            }
+        }
+
+
+        for (std::size_t i = 0; i < funcFamily.size(); ++i) {
+            const auto& vars = all_func_dependant_variables.at(i);
+            const auto& func = funcFamily[i];
+
+            std::vector<std::string> overloadConstraintVars;
+            std::vector<TypeVar> overloadConstraintTypeVars(overloadVariables);
+            overloadConstraintTypeVars.insert(overloadConstraintTypeVars.end(), vars.begin(), vars.end());
+
+            // Copy the variables from the overload constraint
+            for (const auto& var : overloadVariables) {
+                overloadConstraintVars.push_back(name(var));
+            }
+
+            // Copy the variables from the function definition
+            std::vector<std::string> funcVarNames;
+            for (const auto& var : vars) {
+                funcVarNames.push_back(name(var));
+            }
+            std::copy(funcVarNames.begin(), funcVarNames.end(), std::back_inserter(overloadConstraintVars));
+
+            auto allFuncDefinitionVariablesAssigned = [funcVarNames](const constraint::Env& env) {
+                for (const auto& a : funcVarNames) {
+                    if (!env.IsAssigned(a)) {
+                        return false;
                     }
+                }
+                return true;
+            };
+
+            // Layout: [type, return, args...] from the overload, then [return, args...] from the definition.
+            const std::size_t numArgs = overload.numArgs;
+            const auto argsMatch = numArgs == func.args().size();
+            call.definitions.emplace_back();
+            if (argsMatch) {
+                for (const auto& var : vars) {
+                    call.definitions.back().push_back(rep(var).id());
+                }
+            }
+            call.constraints.push_back(solverConstraints.size());
+            addConstraint(overload.id, overloadConstraintTypeVars, [names = overloadConstraintVars, numArgs, argsMatch, funcValue = values.value(typeDomain.at(i)), check = std::move(allFuncDefinitionVariablesAssigned)](const constraint::Env& env) {
+                if (!check(env)) {
+                    // If not all the variables of the function are assigned, say it's fine, and the other one will pick it up.
+                    return true;
+                }
 
+                if (env.At(names.at(0)) != funcValue) {
+                    // This is not the overload we are looking for.
+                    return true;
+                }
+
+                // This is the the overload, check everything matches up.
+                if (!argsMatch) {
                     return false;
-                });
-            } else {
-                std::cout << "Malformed Conforms Constraint" << std::endl;
-                return std::nullopt;
-            }
-        } else if (constraint.has_types()) {
-            const auto types = constraint.types();
-            std::vector<std::string> type_names;
-            if (types.has_first()) {
-                type_names.push_back(types.first().symbol());
-            }
-            if (types.has_second()) {
-                type_names.push_back(types.second().symbol());
-            }
-            if (types.has_third()) {
-                type_names.push_back(types.third().symbol());
-            }
-
-            if (type_names.empty()) {
-                std::cout << "Malformed Types Constraint" << std::endl;
-            } else {
-                // Special handling for ArrayElement constraints
-                if (constraint.kind() == ArrayElement) {
-                    // First type is array, second is element
-                    // Element gets full domain which includes both base types and array types
-                    constraint::Domain::data_type elementDomain = varDomain.data();
-                    
-                    // Also add array types to the element domain to support nested arrays
-                    constraint::Domain::data_type arrayTypesForElements;
-                    for (const auto& ty : varDomain.data()) {
-                        arrayTypesForElements.emplace_back("Array[" + ty.to_string() + "]");
-                    }
-                    elementDomain.insert(elementDomain.end(), arrayTypesForElements.begin(), arrayTypesForElements.end());
-                    insert_if_not_exists(type_names.at(1), constraint::Domain(elementDomain));
-                    
-                    // Array gets domain of Array[T] for each T in the element domain (including nested arrays)
-                    constraint::Domain::data_type arrayDomain;
-                    for (const auto& ty : elementDomain) {
-                        arrayDomain.emplace_back("Array[" + ty.to_string() + "]");
-                    }
-                    insert_if_not_exists(type_names.at(0), arrayDomain);
-                } else {
-                    for (const auto& ty : type_names) {
-                        insert_if_not_exists(ty, varDomain);
-                    }
                 }
 
-                switch (constraint.kind()) {
-                case Conversion:
-                    constraint_solver.AddConstraint(std::vector{type_names}, [type_names, C = &convertible](const constraint::Env& env) {
-                        const auto firstVarValue = env.At(type_names.at(0));
-                        const auto secondVarValue = env.At(type_names.at(1));
-
-                        if (firstVarValue == secondVarValue) {
-                            return true;
-                        }
-
-                        const auto it = C->find(firstVarValue.to_string());
-                        if (it == C->end()) {
-                            return false;
-                        }
-
-                        return it->second.find(secondVarValue.to_string()) != it->second.end();
-                    });
-                    break;
-                case Equal:
-                    constraint_solver.AddConstraint(std::vector{type_names}, [type_names](const constraint::Env& env) {
-                        const auto firstVar = env.At(type_names.at(0));
-                        for (const auto& ty : type_names) {
-                            const auto currentVar = env.At(ty);
-                            if (firstVar != currentVar) {
-                                // Check if both are arrays - if so, their element types must be equal
-                                const auto firstStr = firstVar.to_string();
-                                const auto currentStr = currentVar.to_string();
-                                
-                                if (firstStr.starts_with("Array[") && currentStr.starts_with("Array[")) {
-                                    // Extract element types: "Array[ElementType]" -> "ElementType"
-                                    auto firstElement = firstStr.substr(6, firstStr.length() - 7);
-                                    auto currentElement = currentStr.substr(6, currentStr.length() - 7);
-                                    
-                                    // Element types must be equal
-                                    if (firstElement != currentElement) {
-                                        return false;
-                                    }
-                                } else {
-                                    return false;
-                                }
-                            }
-                        }
-
-                        return true;
-                    });
-                    break;
-                case ArrayElement:
-                    // ArrayElement constraint: arrayVar (first) is Array<elementVar (second)>
-                    constraint_solver.AddConstraint(std::vector{type_names}, [type_names](const constraint::Env& env) {
-                        const auto arrayVarValue = env.At(type_names.at(0)).to_string();
-                        const auto elementVarValue = env.At(type_names.at(1)).to_string();
-                        
-                        // Check if arrayVar is "Array[elementVar]"
-                        const std::string expectedArrayType = "Array[" + elementVarValue + "]";
-                        return arrayVarValue == expectedArrayType;
-                    });
-                    break;
-				case Bind:
-				case BindParam:
-				case BindOverload:
-				case ConformsTo:
-				case ApplicableFunction:
-                default:
-                    std::cout << "Unimplemented Constraint Kind: " << constraint.kind() << std::endl;
-                    assert(false);
-                    break;
+                // Return var, then each argument, of the overload against the definition.
+                for (std::size_t j = 0; j <= numArgs; ++j) {
+                    if (env.At(names.at(1 + j)) != env.At(names.at(2 + numArgs + j))) {
+                        return false;
+                    }
                 }
+
+                return true;
+            }, false);
+        }
+        overloadCalls.push_back(std::move(call));
+    }
+
+    for (const auto& conforms : this->store.conforms()) {
+        const auto& typeVar = conforms.var;
+        const auto& var = name(typeVar);
+        std::vector<ValueTable::IDType> domain;
+        switch (conforms.protocol.literal()) {
+        case KnownProtocolKind::ExpressibleByFloat:
+            AddLiteralProtocolTypes<ExpressibleByFloatLiteral>(domain, values, this->typeTable);
+            AddHeuristicProtocolFuncs<ExpressibleByFloatLiteral>(heuristcFuncs, distanceFuncs, var, values, this->typeTable);
+            break;
+        case KnownProtocolKind::ExpressibleByDouble:
+            AddLiteralProtocolTypes<ExpressibleByDoubleLiteral>(domain, values, this->typeTable);
+            AddHeuristicProtocolFuncs<ExpressibleByDoubleLiteral>(heuristcFuncs, distanceFuncs, var, values, this->typeTable);
+            break;
+        case KnownProtocolKind::ExpressibleByInteger:
+            AddLiteralProtocolTypes<ExpressibleByIntegerLiteral>(domain, values, this->typeTable);
+            AddHeuristicProtocolFuncs<ExpressibleByIntegerLiteral>(heuristcFuncs, distanceFuncs, var, values, this->typeTable);
+            break;
+		case KnownProtocolKind::ExpressibleByArray:
+		case KnownProtocolKind::ExpressibleByBoolean:
+		case KnownProtocolKind::ExpressibleByDictionary:
+		case KnownProtocolKind::ExpressibleByNil:
+		case KnownProtocolKind::ExpressibleByString:
+        default:
+            std::cout << "Unsupported Literal" << std::endl;
+            return SolveResult{};
+            break;
+        }
+
+        heuristicVars.push_back(rep(typeVar).id());
+        heuristicSources.push_back(conforms.id);
+
+        // conforms literal is implied by its domain. A literal type is interned once
+        // anything mentions it, registered or not, and only registered ones are candidates.
+        restrict(typeVar, domain);
+        *restrictedDomains.at(rep(typeVar).id()) &= fullDomain;
+    }
+
+    // Matrix index of each value, the registration index of the type it stands for.
+    std::vector<std::size_t> matrixIndex;
+    if (!this->store.conversions().empty()) {
+        this->buildConversionMatrix();
+        matrixIndex.resize(values.size(), ConvertibilityMatrix::npos);
+        for (std::size_t i = 0; i < this->registeredTypes.size(); ++i) {
+            const auto value = values.find_type(this->registeredTypes.at(i));
+            if (value != ValueTable::npos && value < matrixIndex.size()) {
+                matrixIndex.at(value) = i;
             }
-        } else if (constraint.has_overload()) {
-            const auto overload = constraint.overload();
-
-            std::vector<std::string> overloadVariables;
-            overloadVariables.emplace_back(overload.type().symbol());
-            overloadVariables.emplace_back(overload.returnvar().symbol());
-            for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
-                overloadVariables.emplace_back(overload.argvars(i).symbol());
-            }
-
-            // Gather all overloads.
-            const auto funcFamily = this->getFunctionOverloads(overload.functionid());
-            std::vector<std::vector<std::string>> all_func_dependant_variables;
-            constraint::Domain::data_type typeDomain;
-            for (const auto& func : funcFamily) {
-                std::vector<std::string> funcDependantVariables;
-                funcDependantVariables.emplace_back(func.returnvar().symbol());
-                for (const auto& arg : func.args()) {
-                    funcDependantVariables.emplace_back(arg.symbol());
+        }
+
+        for (const auto& conversion : this->store.conversions()) {
+            use(conversion.first);
+            use(conversion.second);
+            binaryConstraints.push_back(BinaryConstraint{Conversion, rep(conversion.first).id(), rep(conversion.second).id()});
+
+            const std::vector<std::string> type_names{name(conversion.first), name(conversion.second)};
+            addConstraint(conversion.id, {conversion.first, conversion.second}, [type_names, V = &values, M = &this->conversionMatrix, I = &matrixIndex](const constraint::Env& env) {
+                const auto firstVarValue = env.At(type_names.at(0));
+                const auto secondVarValue = env.At(type_names.at(1));
+
+                if (firstVarValue == secondVarValue) {
+                    return true;
+                }
+
+                const auto from = V->decode(firstVarValue);
+                const auto to = V->decode(secondVarValue);
+                if (from >= I->size() || to >= I->size()) {
+                    return false;
                 }
 
-                all_func_dependant_variables.emplace_back(funcDependantVariables);
-                typeDomain.emplace_back(func.serialize());
+                return M->converts(I->at(from), I->at(to));
+            }, true);
+        }
+    }
+
+    auto overloadOf = [this](const OverloadKey& key) -> const FunctionVar& {
+        return this->getFunctionOverload(key);
+    };
+
+    // Every other member of a class resolves to its representative's type.
+    auto resolveMembers = [&](ConstraintPass& pass) {
+        for (TypeVar::IDType id = 0; id < this->numTypeVars; ++id) {
+            const auto representative = rep(TypeVar(id));
+            if (usedVars.at(id) && representative.id() != id) {
+                pass.SetResolvedAlias(TypeVar(id), representative);
+            }
+        }
+    };
+
+    // Filter domains through the two-var constraints before any search.
+    stats->variables = all_variables.size();
+    // Binds reach further through each pass, until neither narrows anything.
+    for (auto removed = std::numeric_limits<std::size_t>::max(); removed != 0;) {
+        removed = PruneDomains(restrictedDomains, fullDomain, binaryConstraints, values, this->conversionMatrix, matrixIndex);
+        removed += PropagateOverloads(restrictedDomains, fullDomain, overloadCalls, solverConstraints);
+        stats->prunedValues += removed;
+    }
+    auto domainOf = [&](const TypeVar& var) -> const ValueDomain& {
+        const auto& restricted = restrictedDomains.at(rep(var).id());
+        return restricted.has_value() ? *restricted : fullDomain;
+    };
+
+    // Split the solver variables into groups that share no constraint. A var propagation
+    // fixed to one value links nothing: it joins the group of the first constraint that
+    // reads it, and every other group that mentions it gets its own copy.
+    std::vector<Component> components;
+    {
+        auto fixed = [&](const TypeVar::IDType var) {
+            return domainOf(TypeVar(var)).size() == 1;
+        };
+        auto anchor = [&](const SearchConstraint& constraint) {
+            const auto it = std::find_if_not(constraint.vars.begin(), constraint.vars.end(), fixed);
+            return it != constraint.vars.end() ? *it : constraint.vars.front();
+        };
+
+        TypeVarClasses linked(this->numTypeVars);
+        std::vector<bool> homed(this->numTypeVars, false);
+        for (const auto& constraint : solverConstraints) {
+            const auto first = anchor(constraint);
+            homed.at(first) = true;
+            for (const auto& var : constraint.vars) {
+                if (!fixed(var)) {
+                    linked.unite(first, var);
+                } else if (!homed.at(var)) {
+                    homed.at(var) = true;
+                    linked.unite(first, var);
+                }
             }
+        }
 
-            insert_if_not_exists(overload.type().symbol(), typeDomain);
-            for (const auto& a : overloadVariables) {
-                insert_if_not_exists(a, varDomain);
+        std::vector<std::size_t> componentOf(this->numTypeVars, std::numeric_limits<std::size_t>::max());
+        auto componentIndex = [&](const TypeVar::IDType var) {
+            auto& index = componentOf.at(linked.find(var));
+            if (index == std::numeric_limits<std::size_t>::max()) {
+                index = components.size();
+                components.emplace_back();
             }
-            for (const auto& a : all_func_dependant_variables) {
-                for (const auto& b : a) {
-                    insert_if_not_exists(b, varDomain);
+            return index;
+        };
+        for (const auto& var : all_variables) {
+            components.at(componentIndex(var.id())).vars.push_back(var);
+        }
+
+        std::vector<std::size_t> sharedWith(this->numTypeVars, std::numeric_limits<std::size_t>::max());
+        for (std::size_t c = 0; c < solverConstraints.size(); ++c) {
+            const auto& constraint = solverConstraints.at(c);
+            const auto index = componentIndex(anchor(constraint));
+            auto& component = components.at(index);
+            component.constraints.push_back(c);
+            for (const auto& var : constraint.vars) {
+                if (componentIndex(var) != index && sharedWith.at(var) != index) {
+                    sharedWith.at(var) = index;
+                    component.shared.emplace_back(var);
                 }
             }
+        }
+        for (std::size_t h = 0; h < heuristicVars.size(); ++h) {
+            components.at(componentIndex(heuristicVars.at(h))).heuristics.push_back(h);
+        }
+    }
+    stats->components = components.size();
+
+    // Solved value of each solver variable, by representative ID.
+    std::vector<ValueTable::IDType> assigned(this->numTypeVars, ValueTable::npos);
+
+    enum class Outcome : std::uint8_t { Solved, Failed, Search, Unfinished };
+
+    // Settles a component from its propagated domains when no search is needed.
+    auto decideComponent = [&](const Component& component) {
+        bool decided = true;
+        for (const auto& var : component.vars) {
+            const auto size = domainOf(var).size();
+            if (size == 0) {
+                // Unsatisfiable, no search can fix an empty domain.
+                std::cout << "Warning: Domain Empty for variable: " << name(var) << std::endl;
+                return Outcome::Failed;
+            }
+            decided = decided && size == 1;
+        }
+        decided = decided && std::all_of(component.constraints.begin(), component.constraints.end(), [&](const std::size_t c) {
+            return solverConstraints.at(c).propagated;
+        });
+        if (!decided) {
+            return Outcome::Search;
+        }
 
+        // Propagation decided every var, and checked every constraint between them.
+        for (const auto& var : component.vars) {
+            assigned.at(var.id()) = domainOf(var).front();
+        }
+        return Outcome::Solved;
+    };
 
-            for (std::size_t i = 0; i < funcFamily.size(); ++i) {
-                const auto& vars = all_func_dependant_variables.at(i);
-                const auto& func = funcFamily.at(i);
+    std::vector<bool> isCallType(this->numTypeVars, false);
+    std::vector<bool> isLiteral(this->numTypeVars, false);
+    if (this->portfolioSolve) {
+        for (const auto& call : overloadCalls) {
+            isCallType.at(call.type) = true;
+        }
+        for (const auto var : heuristicVars) {
+            isLiteral.at(var) = true;
+        }
+    }
+    auto ordered = [&](std::vector<TypeVar> vars, const SearchOrder order) {
+        switch (order) {
+        case SearchOrder::FewestValuesFirst:
+            std::stable_sort(vars.begin(), vars.end(), [&](const TypeVar& a, const TypeVar& b) {
+                return domainOf(a).size() < domainOf(b).size();
+            });
+            break;
+        case SearchOrder::CallsFirst:
+            std::stable_partition(vars.begin(), vars.end(), [&](const TypeVar& var) { return isCallType.at(var.id()); });
+            break;
+        case SearchOrder::LiteralsFirst:
+            std::stable_partition(vars.begin(), vars.end(), [&](const TypeVar& var) { return isLiteral.at(var.id()); });
+            break;
+        case SearchOrder::Given:
+        default:
+            break;
+        }
+        return vars;
+    };
 
-                std::vector<std::string> overloadConstraintVars;
+    // A portfolio searches each component once per order, so it can't hand over its
+    // constraints and heuristics.
+    const bool racing = this->portfolioSolve && this->solvePool != nullptr;
+    auto take = [racing](auto& item) -> std::decay_t<decltype(item)> {
+        if (racing) {
+            return item;
+        }
+        return std::move(item);
+    };
 
-                // Copy the variables from the overload constraint
-                std::copy(overloadVariables.begin(), overloadVariables.end(), std::back_inserter(overloadConstraintVars));
+    using Assignment = std::vector<ValueTable::IDType>;
+    using DistanceType = constraint::Node::distance_type;
 
-                // Copy the variables from the function definition
-                std::copy(vars.begin(), vars.end(), std::back_inserter(overloadConstraintVars));
+    // The closest a search got to a solution, kept when a partial result is asked for.
+    struct Progress {
+        DistanceType distance = std::numeric_limits<DistanceType>::max();
+        Assignment values;
+    };
 
-                auto allFuncDefinitionVariablesAssigned = [vars](const constraint::Env& env) {
-                    for (const auto& a : vars) {
-                        if (!env.IsAssigned(a)) {
-                            return false;
-                        }
-                    }
-                    return true;
-                };
+    // The budget of the whole solve. A race instead gives every order of every group it
+    // searches its own even share, so no search's limit depends on how far a search on
+    // another thread got.
+    SearchBudget solveBudget(options);
+    std::size_t racedGroups = 1; // Set once the groups to search are known
+    std::atomic<std::size_t> racedNodes = 0;
+    std::atomic<bool> raceCancelled = false;
+
+    // One search of `component`, the value of each of its vars or npos where the solution
+    // leaves one out, counting into `expansions`. Throws SearchStopped once it expanded
+    // more than `fewest` or the budget is spent, with `progress`, when given, holding the
+    // best state it expanded.
+    auto runSearch = [&](Component& component, const SearchOrder order, SearchBudget& budget, const std::atomic<std::size_t>* fewest, std::size_t& expansions, Progress* progress) -> std::optional<Assignment> {
+        constraint::Solver constraint_solver;
+        for (const auto& var : ordered(component.vars, order)) {
+            constraint_solver.AddVariable(name(var), toDomain(domainOf(var)));
+        }
+        for (const auto& var : component.shared) {
+            constraint_solver.AddVariable(name(var), toDomain(domainOf(var)));
+        }
+        for (const auto c : component.constraints) {
+            auto& constraint = solverConstraints.at(c);
+            constraint_solver.AddConstraint(take(constraint.names), take(constraint.check));
+        }
 
-                constraint_solver.AddConstraint(overloadConstraintVars, [overload, funcDefinition = func, check = std::move(allFuncDefinitionVariablesAssigned)](const constraint::Env& env) {
-                    if (!check(env)) {
-                        // If not all the variables of the function are assigned, say it's fine, and the other one will pick it up.
-                        return true;
-                    }
+        std::vector<constraint::Solver::DistanceFunc> heuristics;
+        std::vector<constraint::Solver::DistanceFunc> actuals;
+        for (const auto h : component.heuristics) {
+            heuristics.push_back(take(heuristcFuncs.at(h)));
+            actuals.push_back(take(distanceFuncs.at(h)));
+        }
 
-                    if (env.At(overload.type().symbol()).to_string() != funcDefinition.serialize()) {
-                        // This is not the overload we are looking for.
-                        return true;
-                    }
+        auto record = [&component, &name, &values, progress](const constraint::StateQuery& state, const DistanceType distance) {
+            if (progress == nullptr || distance >= progress->distance) {
+                return;
+            }
+            progress->distance = distance;
+            progress->values.clear();
+            for (const auto& var : component.vars) {
+                progress->values.push_back(state.IsAssigned(name(var)) ? values.decode(state.At(name(var))) : ValueTable::npos);
+            }
+        };
 
-                    auto compare_vars = [&env](const TypeVar& vA, const TypeVar& vB) {
-                        return env.At(vA.symbol()).to_string() == env.At(vB.symbol()).to_string();
-                    };
+        const auto numVariables = (DistanceType)component.vars.size();
+        auto heuristic = [heuristics = std::move(heuristics), numVariables, fewest, record, &budget, &expansions](const constraint::StateQuery& state) {
+            ++expansions;
+            if (!budget.expand() || (fewest != nullptr && expansions > fewest->load(std::memory_order_relaxed))) {
+                throw SearchStopped{};
+            }
 
-                    // This is the the overload, check everything matches up.
-                    if (overload.argvars_size() != funcDefinition.args().size()) {
-                        return false;
-                    }
+            // Calculate the difference, allows us to measure meaningful progress
+            DistanceType sum = numVariables + (DistanceType)state.NumConstraints() - (DistanceType)state.NumSatisfied();
+            for (const auto& H : heuristics) {
+                sum += H(state);
+            }
+            record(state, sum);
+            return sum;
+        };
+
+        auto actualDistance = [actual = std::move(actuals), numVariables](const constraint::StateQuery& state) {
+            // Calculate the difference, allows us to measure meaningful progress
+            DistanceType sum = numVariables + (DistanceType)state.NumConstraints();
+            for (const auto& G : actual) {
+                sum += G(state);
+            }
+            return sum;
+        };
 
-                    if (!compare_vars(overload.returnvar(), funcDefinition.returnvar())) {
-                        return false;
-                    }
+        const auto solution = constraint_solver.GetOptimizedSolution(std::move(heuristic), std::move(actualDistance));
+        if (!solution.has_value()) {
+            return std::nullopt;
+        }
 
-                    for (std::size_t i = 0; i < funcDefinition.args().size(); ++i) {
-                        if (!compare_vars(overload.argvars(i), funcDefinition.args().at(i))) {
-                            return false;
-                        }
+        Assignment result;
+        for (const auto& var : component.vars) {
+            // Not necessarily an error, as the caller could accept partial solutions.
+            result.push_back(solution->Contains(name(var)) ? values.decode(solution->At(name(var))) : ValueTable::npos);
+        }
+        return result;
+    };
+
+    // Searches one component into `assigned`. It only touches its own vars, constraints
+    // and heuristics, so components can be searched concurrently.
+    auto searchComponent = [&](Component& component) {
+        std::vector<Progress> progress(racing ? searchOrders.size() : 1);
+        auto progressOf = [&](const std::size_t i) {
+            return options.partialResult ? &progress.at(i) : nullptr;
+        };
+
+        std::optional<Assignment> solution;
+        bool finished = false;
+        if (!racing) {
+            try {
+                std::size_t expansions = 0;
+                solution = runSearch(component, SearchOrder::Given, solveBudget, nullptr, expansions, progressOf(0));
+                finished = true;
+            } catch (const SearchStopped&) {
+                // Out of budget, or cancelled.
+            }
+        } else {
+            // Every search is complete, so any finished order has the answer, found or not.
+            // The one with the fewest expansions wins, ties going to the earlier order, so
+            // the result doesn't depend on which thread got there first. An order stops once
+            // it expanded more than a finished one, as it can no longer win.
+            std::deque<SearchBudget> budgets;
+            for (std::size_t i = 0; i < searchOrders.size(); ++i) {
+                budgets.emplace_back(options, racedGroups * searchOrders.size());
+            }
+            std::atomic<std::size_t> fewest = std::numeric_limits<std::size_t>::max();
+            std::size_t winner = searchOrders.size();
+            std::mutex mutex;
+            this->solvePool->parallelFor(searchOrders.size(), [&](const std::size_t i) {
+                try {
+                    std::size_t expansions = 0;
+                    auto result = runSearch(component, searchOrders.at(i), budgets.at(i), &fewest, expansions, progressOf(i));
+                    std::lock_guard lock(mutex);
+                    const auto current = fewest.load(std::memory_order_relaxed);
+                    if (expansions < current || (expansions == current && i < winner)) {
+                        fewest.store(expansions, std::memory_order_relaxed);
+                        winner = i;
+                        solution = std::move(result);
+                        finished = true;
                     }
+                } catch (const SearchStopped&) {
+                    // A finished order needed fewer expansions, or the budget ran out, or the solve was cancelled.
+                }
+            });
+            for (const auto& orderBudget : budgets) {
+                racedNodes += orderBudget.expanded();
+                if (orderBudget.wasCancelled()) {
+                    raceCancelled = true;
+                }
+            }
+        }
 
-                    return true;
-                });
+        const Assignment* found = solution.has_value() ? &*solution : nullptr;
+        if (!finished) {
+            // Keep the closest any order got, if anything was kept.
+            const auto best = std::min_element(progress.begin(), progress.end(), [](const Progress& a, const Progress& b) {
+                return a.distance < b.distance;
+            });
+            found = best->values.empty() ? nullptr : &best->values;
+        }
+
+        if (found != nullptr) {
+            for (std::size_t i = 0; i < component.vars.size(); ++i) {
+                if (found->at(i) != ValueTable::npos) {
+                    assigned.at(component.vars.at(i).id()) = found->at(i);
+                }
             }
+        }
+        if (!finished) {
+            return Outcome::Unfinished;
+        }
+        return solution.has_value() ? Outcome::Solved : Outcome::Failed;
+    };
 
-        } else if (constraint.has_explicit()) {
-            const auto explicit_ = constraint.explicit_();
-            if (explicit_.has_var() && explicit_.has_type()) {
-                const auto& var = explicit_.var();
-                const auto& type = explicit_.type();
+    // Everything a component's search depends on. Constraint IDs are never reused while
+    // the cache lives, so an equal key means the same search with the same result.
+    auto componentKey = [&](const Component& component) {
+        std::vector<std::uint64_t> key;
+        // An unrestricted var is keyed as such rather than by the full domain, which every
+        // new overload grows. Equal sets key equally, whatever trailing zeros they keep.
+        constexpr auto unrestricted = std::numeric_limits<std::uint64_t>::max();
+        auto addVars = [&](const std::vector<TypeVar>& vars) {
+            key.push_back(vars.size());
+            for (const auto& var : vars) {
+                key.push_back(var.id());
+                const auto& restricted = restrictedDomains.at(rep(var).id());
+                if (!restricted.has_value()) {
+                    key.push_back(unrestricted);
+                    continue;
+                }
+                auto words = restricted->words();
+                while (!words.empty() && words.back() == 0) {
+                    words = words.first(words.size() - 1);
+                }
+                key.push_back(words.size());
+                key.insert(key.end(), words.begin(), words.end());
+            }
+        };
+        addVars(component.vars);
+        addVars(component.shared);
+        key.push_back(component.constraints.size());
+        for (const auto c : component.constraints) {
+            key.push_back(static_cast<std::uint64_t>(solverConstraints.at(c).source));
+        }
+        for (const auto h : component.heuristics) {
+            key.push_back(static_cast<std::uint64_t>(heuristicSources.at(h)));
+        }
+        return key;
+    };
 
-                // The domain can only the be the explicit type.
-                if (type.has_generic()) {
-                    insert_if_not_exists(var.symbol(), {type.generic().name()});
-                } else if (type.has_func()) {
-                    insert_if_not_exists(var.symbol(), {type.func().name()});
-                } else {
-                    throw std::runtime_error("Unhandled explicit type parsing");
+    auto* cache = this->solveCache.get();
+    if (cache != nullptr) {
+        ++cache->generation;
+    }
+
+    std::vector<Outcome> outcomes;
+    std::vector<std::size_t> searches;
+    std::vector<std::vector<std::uint64_t>> searchKeys;
+    outcomes.reserve(components.size());
+    for (std::size_t c = 0; c < components.size(); ++c) {
+        outcomes.push_back(decideComponent(components.at(c)));
+        if (outcomes.back() == Outcome::Search && cache != nullptr) {
+            auto key = componentKey(components.at(c));
+            const auto found = cache->results.find(key);
+            if (found != cache->results.end()) {
+                // Nothing it depends on changed since it was searched.
+                found->second.generation = cache->generation;
+                for (const auto& [var, value] : found->second.assigned) {
+                    assigned.at(var) = value;
                 }
-                constraint_solver.AddConstraint(std::vector{var.symbol()}, [var, type](const constraint::Env& env) {
-                    if (type.has_generic()) {
-                        return env.At(var.symbol()).to_string() == type.generic().name();
-                    }
+                outcomes.back() = found->second.solved ? Outcome::Solved : Outcome::Failed;
+                ++stats->reusedComponents;
+                continue;
+            }
+            searchKeys.push_back(std::move(key));
+        }
 
-                    return false;
-                });
-            } else {
-                std::cout << "Malformed Explicit Constraint" << std::endl;
-                return std::nullopt;
+        if (outcomes.back() == Outcome::Search) {
+            searches.push_back(c);
+            // Fill the name cache up front, searches only read it.
+            for (const auto& var : components.at(c).vars) {
+                static_cast<void>(name(var));
+            }
+            for (const auto& var : components.at(c).shared) {
+                static_cast<void>(name(var));
             }
-        } else {
-            std::cout << "Unknown Constraint Type" << std::endl;
-            return std::nullopt;
         }
     }
+    stats->searched = !searches.empty();
+    if (!searches.empty() && solveBudget.poll()) {
+        return SolveResult{SolveStatus::Cancelled, std::nullopt};
+    }
 
-    using DistanceType = constraint::Node::distance_type;
-    const auto numVariables = (DistanceType)all_variable_names.size();
-    auto heuristic = [heuristics = std::move(heuristcFuncs), numVariables](const constraint::StateQuery& state) {
-        // Calculate the difference, allows us to measure meaningful progress
-        DistanceType sum = numVariables + (DistanceType)state.NumConstraints() - (DistanceType)state.NumSatisfied();
-        for (const auto& H : heuristics) {
-            sum += H(state);
-        }
-        return sum;
+    racedGroups = std::max<std::size_t>(searches.size(), 1);
+    auto search = [&](const std::size_t i) {
+        const auto c = searches.at(i);
+        outcomes.at(c) = searchComponent(components.at(c));
     };
+    if (this->solvePool != nullptr && searches.size() > 1) {
+        this->solvePool->parallelFor(searches.size(), search);
+    } else {
+        for (std::size_t i = 0; i < searches.size(); ++i) {
+            search(i);
+        }
+    }
+
+    stats->nodes = solveBudget.expanded() + racedNodes.load();
 
-    auto actualDistance = [actual = std::move(distanceFuncs), numVariables](const constraint::StateQuery& state) {
-        // Calculate the difference, allows us to measure meaningful progress
-        DistanceType sum = numVariables + (DistanceType)state.NumConstraints();
-        for (const auto& G : actual) {
-            sum += G(state);
+    if (cache != nullptr) {
+        for (std::size_t i = 0; i < searches.size(); ++i) {
+            if (outcomes.at(searches.at(i)) == Outcome::Unfinished) {
+                continue;
+            }
+            const auto& component = components.at(searches.at(i));
+            SolveCache::Result result;
+            result.solved = outcomes.at(searches.at(i)) == Outcome::Solved;
+            result.generation = cache->generation;
+            for (const auto& var : component.vars) {
+                result.assigned.emplace_back(var.id(), assigned.at(var.id()));
+            }
+            cache->results.insert_or_assign(std::move(searchKeys.at(i)), std::move(result));
         }
-        return sum;
-    };
 
-    const auto solution = constraint_solver.GetOptimizedSolution(std::move(heuristic), std::move(actualDistance));
-    const auto hasSolution = solution.has_value();
-    if (!hasSolution) {
-        return std::nullopt;
+        // Only keep what this solve used, the next edit starts from here.
+        std::erase_if(cache->results, [generation = cache->generation](const auto& entry) {
+            return entry.second.generation != generation;
+        });
+    }
+
+    // Merged in component order, whichever thread finished first.
+    std::vector<std::size_t> failed;
+    bool unfinished = false;
+    for (std::size_t c = 0; c < components.size(); ++c) {
+        if (outcomes.at(c) == Outcome::Failed) {
+            failed.push_back(c);
+        }
+        unfinished = unfinished || outcomes.at(c) == Outcome::Unfinished;
+    }
+
+    if (!failed.empty()) {
+        // Report every type var of the failing components, not just their representatives,
+        // along with the fixed vars their constraints read from other components.
+        std::vector<std::vector<std::size_t>> failedIndices(this->numTypeVars);
+        for (std::size_t i = 0; i < failed.size(); ++i) {
+            const auto& component = components.at(failed.at(i));
+            for (const auto& var : component.vars) {
+                failedIndices.at(var.id()).push_back(i);
+            }
+            for (const auto& var : component.shared) {
+                failedIndices.at(var.id()).push_back(i);
+            }
+        }
+        stats->failedComponents.resize(failed.size());
+        for (TypeVar::IDType id = 0; id < this->numTypeVars; ++id) {
+            if (!usedVars.at(id)) {
+                continue;
+            }
+            for (const auto index : failedIndices.at(rep(TypeVar(id)).id())) {
+                stats->failedComponents.at(index).emplace_back(id);
+            }
+        }
+        return SolveResult{};
+    }
+    if (unfinished && (solveBudget.wasCancelled() || raceCancelled.load())) {
+        return SolveResult{SolveStatus::Cancelled, std::nullopt};
+    }
+    if (unfinished && !options.partialResult) {
+        return SolveResult{SolveStatus::TimedOut, std::nullopt};
     }
 
+    auto valueOf = [&](const TypeVar& var) {
+        return assigned.at(rep(var).id());
+    };
+
     ConstraintPass pass;
-    for (const auto& var : all_variable_names) {
-        if (!solution->Contains(var)) {
-            // Not necessarily an error, as the caller could accept partial solutions.
+    for (const auto& var : all_variables) {
+        const auto value = valueOf(var);
+        if (value == ValueTable::npos) {
             continue;
         }
 
-        const auto val = solution->At(var);
         try {
-            pass.SetResolvedType(var, TypeFromString(val.to_string(), *solution));
+            pass.SetResolvedType(var, TypeFromValue(values, value, this->typeTable, valueOf, overloadOf));
         } catch (...) {
             continue;
         }
     }
-    return pass;
+    resolveMembers(pass);
+    return SolveResult{unfinished ? SolveStatus::TimedOut : SolveStatus::Solved, std::move(pass)};
 }
@@ -1,6 +1,13 @@
 #include "cpptest/cpptest.hpp"
 #include "Utils.test.hpp"
 
+#include <stdexcept>
+
+#ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
+#include <chrono>
+#include <iostream>
+#endif
+
 class TypeManagerTest : public cpptest::BaseCppTest {
 public:
     void SetUp() {
@@ -78,4 +85,303 @@ NEW_TEST(TypeManagerTest, LoadBasicTypeConversions) {
     CPPTEST_EXPECT_FALSE(tm.isConvertible("double", "float"));
 }
 
+NEW_TEST(TypeManagerTest, CreateTypeVarsAreDenseHandles) {
+    typecheck::TypeManager tm;
+    const auto T0 = tm.CreateTypeVar();
+    const auto T1 = tm.CreateTypeVar();
+    CPPTEST_EXPECT_EQ(T0.id(), 0);
+    CPPTEST_EXPECT_EQ(T1.id(), 1);
+    CPPTEST_EXPECT_NEQ(T0, T1);
+    CPPTEST_EXPECT_EQ(T1.symbol(), "T1");
+}
+
+NEW_TEST(TypeManagerTest, RegisterGenericTypes) {
+    typecheck::TypeManager tm;
+    typecheck::GenericType intArray("Array");
+    intArray.add_type_param()->mutable_generic()->set_name("int");
+
+    CPPTEST_ASSERT_THAT(tm.registerType(typecheck::Type(intArray)));
+    CPPTEST_EXPECT_FALSE(tm.registerType(typecheck::Type(intArray)));
+    CPPTEST_EXPECT_THAT(tm.hasRegisteredType(typecheck::Type(intArray)));
+
+    // Registering Array<int> does not register its element type.
+    CPPTEST_EXPECT_FALSE(tm.hasRegisteredType("int"));
+    CPPTEST_EXPECT_EQ(tm.getRegisteredType(typecheck::Type(intArray)), typecheck::Type(intArray));
+}
+
+NEW_TEST(TypeManagerTest, GetConstraintByID) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 4);
+
+    const auto bindID = tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+    tm.CreateArrayElementConstraint(T.at(1), T.at(2));
+    tm.CreateArrayElementConstraint(T.at(3), T.at(0));
+
+    // Auto-generates an element equality constraint ahead of this one.
+    const auto equalsID = tm.CreateEqualsConstraint(T.at(1), T.at(3));
+
+    const auto* bind = tm.getConstraint(bindID);
+    CPPTEST_ASSERT_THAT(bind != nullptr);
+    CPPTEST_EXPECT_EQ(bind->id(), bindID);
+    CPPTEST_EXPECT_EQ(bind->kind(), typecheck::ConstraintKind::Bind);
+
+    const auto* equals = tm.getConstraint(equalsID);
+    CPPTEST_ASSERT_THAT(equals != nullptr);
+    CPPTEST_EXPECT_EQ(equals->id(), equalsID);
+    CPPTEST_EXPECT_EQ(equals->types().first(), T.at(1));
+
+    CPPTEST_EXPECT_THAT(tm.getConstraint(-1) == nullptr);
+    CPPTEST_EXPECT_THAT(tm.getConstraint(equalsID + 100) == nullptr);
+}
+
+NEW_TEST(TypeManagerTest, RemoveConstraintCleansDerivedState) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 4);
+
+    const auto bindID = tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+    const auto firstArrayID = tm.CreateArrayElementConstraint(T.at(1), T.at(2));
+    const auto secondArrayID = tm.CreateArrayElementConstraint(T.at(3), T.at(0));
+    const auto equalsID = tm.CreateEqualsConstraint(T.at(1), T.at(3));
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), 5);
+    CPPTEST_EXPECT_EQ(tm.getConstraintStore().equals().size(), 2);
+
+    // The element equality goes with the Equal that generated it.
+    CPPTEST_EXPECT_TRUE(tm.removeConstraint(equalsID));
+    CPPTEST_EXPECT_FALSE(tm.removeConstraint(equalsID));
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), 3);
+    CPPTEST_EXPECT_TRUE(tm.getConstraintStore().equals().empty());
+    CPPTEST_EXPECT_THAT(tm.getConstraint(equalsID) == nullptr);
+    CPPTEST_EXPECT_EQ(tm.getConstraint(secondArrayID)->id(), secondArrayID);
+
+    // Without its ArrayElement, T3 is no longer an array, so no element equality is made.
+    const std::vector<typecheck::Constraint::IDType> batch{secondArrayID, bindID, equalsID + 100};
+    CPPTEST_EXPECT_EQ(tm.removeConstraints(batch), 2);
+    tm.CreateEqualsConstraint(T.at(1), T.at(3));
+    CPPTEST_EXPECT_EQ(tm.getConstraintStore().equals().size(), 1);
+    CPPTEST_EXPECT_EQ(tm.getConstraintStore().arrayElements().size(), 1);
+    CPPTEST_EXPECT_EQ(tm.getConstraintStore().arrayElements().front().id, firstArrayID);
+    CPPTEST_EXPECT_TRUE(tm.getConstraintStore().binds().empty());
+}
+
+NEW_TEST(TypeManagerTest, RemoveAfterMarkRejectsReset) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 3);
+    tm.CreateArrayElementConstraint(T.at(0), T.at(1));
+    const auto mark = tm.mark();
+    const auto elementID = tm.CreateArrayElementConstraint(T.at(0), T.at(2));
+    const auto bindID = tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("int"));
+    CPPTEST_EXPECT_TRUE(tm.removeConstraint(bindID));
+
+    // The mark's sizes no longer line up with the compacted constraints.
+    bool rejected = false;
+    try {
+        tm.resetToMark(mark);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    CPPTEST_EXPECT_TRUE(rejected);
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), 2);
+    CPPTEST_EXPECT_EQ(tm.getConstraint(elementID)->id(), elementID);
+
+    // A mark taken after the removal still works.
+    const auto after = tm.mark();
+    tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("float"));
+    tm.resetToMark(after);
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), 2);
+    CPPTEST_EXPECT_EQ(tm.getConstraintStore().arrayElements().size(), 2);
+    CPPTEST_EXPECT_TRUE(tm.getConstraintStore().binds().empty());
+}
+
+NEW_TEST(TypeManagerTest, RemoveOverloadCallKeepsOtherArgs) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 8);
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a", "b"});
+
+    tm.CreateBindFunctionConstraint(fooHash, T.at(0), {T.at(1), T.at(2)}, T.at(3));
+    const auto middleID = tm.CreateBindFunctionConstraint(fooHash, T.at(4), {T.at(5)}, T.at(3));
+    tm.CreateBindFunctionConstraint(fooHash, T.at(6), {T.at(7), T.at(1)}, T.at(3));
+    CPPTEST_EXPECT_TRUE(tm.removeConstraint(middleID));
+
+    const auto& store = tm.getConstraintStore();
+    CPPTEST_ASSERT_THAT(store.overloads().size() == 2);
+    const auto last = store.args(store.overloads().back());
+    CPPTEST_ASSERT_THAT(last.size() == 2);
+    CPPTEST_EXPECT_EQ(last[0], T.at(7));
+    CPPTEST_EXPECT_EQ(last[1], T.at(1));
+}
+
+NEW_TEST(TypeManagerTest, RemovedConstraintNoLongerConstrainsSolve) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 3);
+
+    tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("double"));
+    tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("int"));
+    const auto conversionID = tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+    tm.CreateApplicableFunctionConstraint(tm.CreateFunctionHash("foo", {}), {}, tm.getRegisteredType("int"));
+    tm.CreateBindFunctionConstraint(tm.CreateFunctionHash("foo", {}), T.at(2), {}, T.at(1));
+    CPPTEST_EXPECT_FALSE(tm.solve().has_value());
+
+    CPPTEST_EXPECT_TRUE(tm.removeConstraint(conversionID));
+    const auto solution = tm.solve();
+    CPPTEST_ASSERT_THAT(solution.has_value());
+    CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(0)), tm.getRegisteredType("double"));
+    CPPTEST_ASSERT_THAT(solution->GetResolvedType(T.at(2)).has_func());
+}
+
+NEW_TEST(TypeManagerTest, ConstraintStoreSplitsByKind) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 6);
+
+    const auto funcID = tm.CreateFunctionHash("foo", {"a", "b"});
+    tm.CreateApplicableFunctionConstraint(funcID, {tm.getRegisteredType("int"), tm.getRegisteredType("float")}, tm.getRegisteredType("int"));
+
+    const auto bindID = tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+    tm.CreateLiteralConformsToConstraint(T.at(1), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+    tm.CreateEqualsConstraint(T.at(1), T.at(2));
+    const auto overloadID = tm.CreateBindFunctionConstraint(funcID, T.at(3), {T.at(0), T.at(1)}, T.at(4));
+    tm.CreateArrayElementConstraint(T.at(5), T.at(2));
+
+    const auto& store = tm.getConstraintStore();
+    CPPTEST_EXPECT_EQ(store.size(), tm.getConstraints().size());
+    // The applicable function binds its return and argument vars.
+    CPPTEST_EXPECT_EQ(store.binds().size(), 4);
+    CPPTEST_EXPECT_EQ(store.conforms().size(), 1);
+    CPPTEST_EXPECT_EQ(store.conversions().size(), 1);
+    CPPTEST_EXPECT_EQ(store.equals().size(), 1);
+    CPPTEST_EXPECT_EQ(store.arrayElements().size(), 1);
+    CPPTEST_ASSERT_THAT(store.overloads().size() == 1);
+
+    const auto& bind = store.binds().back();
+    CPPTEST_EXPECT_EQ(bind.id, bindID);
+    CPPTEST_EXPECT_EQ(bind.var, T.at(0));
+    CPPTEST_EXPECT_EQ(tm.getTypeTable().name(bind.type), "int");
+
+    const auto& overload = store.overloads()[0];
+    CPPTEST_EXPECT_EQ(overload.id, overloadID);
+    CPPTEST_EXPECT_EQ(overload.functionID, funcID);
+    CPPTEST_EXPECT_EQ(overload.type, T.at(3));
+    CPPTEST_EXPECT_EQ(overload.returnVar, T.at(4));
+    const auto args = store.args(overload);
+    CPPTEST_ASSERT_THAT(args.size() == 2);
+    CPPTEST_EXPECT_EQ(args[0], T.at(0));
+    CPPTEST_EXPECT_EQ(args[1], T.at(1));
+
+    CPPTEST_EXPECT_EQ(store.arrayElements()[0].first, T.at(5));
+    CPPTEST_EXPECT_EQ(store.arrayElements()[0].second, T.at(2));
+}
+
+NEW_TEST(TypeManagerTest, ScopesRollBackSpeculativeConstraints) {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 2);
+    tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    const auto baseConstraints = tm.getConstraints().size();
+
+    // Interpretation A binds the literal to void, which can't hold.
+    tm.pushScope();
+    CPPTEST_EXPECT_EQ(tm.scopeDepth(), 1);
+    const auto guess = tm.CreateTypeVar();
+    tm.CreateBindToConstraint(guess, tm.getRegisteredType("void"));
+    tm.CreateEqualsConstraint(T.at(0), guess);
+    CPPTEST_EXPECT_FALSE(tm.solve().has_value());
+    tm.popScope();
+    CPPTEST_EXPECT_EQ(tm.scopeDepth(), 0);
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), baseConstraints);
+    CPPTEST_EXPECT_EQ(tm.getConstraintStore().size(), baseConstraints);
+    CPPTEST_EXPECT_EQ(tm.CreateTypeVar().id(), guess.id());
+
+    // Interpretation B converts it to float, and is kept.
+    tm.pushScope();
+    tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("float"));
+    tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+    tm.pushScope();
+    tm.CreateArrayElementConstraint(tm.CreateTypeVar(), T.at(1));
+    tm.popScope();
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), baseConstraints + 2);
+    tm.commitScope();
+    CPPTEST_EXPECT_EQ(tm.scopeDepth(), 0);
+    CPPTEST_EXPECT_EQ(tm.getConstraints().size(), baseConstraints + 2);
+
+    const auto solution = tm.solve();
+    CPPTEST_ASSERT_THAT(solution.has_value());
+    CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(1)), tm.getRegisteredType("float"));
+}
+
+NEW_TEST(TypeManagerTest, ResetToMarkKeepsPrelude) {
+    getDefaultTypeManager(tm);
+    const auto funcID = tm.CreateFunctionHash("foo", {"a"});
+    tm.CreateApplicableFunctionConstraint(funcID, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+    const auto preludeConstraints = tm.getConstraints().size();
+    const auto preludeTypes = tm.getTypeTable().size();
+
+    const auto mark = tm.mark();
+    for (int unit = 0; unit < 3; ++unit) {
+        const auto T = CreateMultipleSymbols(tm, 4);
+        CPPTEST_EXPECT_EQ(T.at(0).id(), mark.numTypeVars);
+
+        const auto funcVar = tm.CreateTypeVar();
+        tm.CreateApplicableFunctionConstraint(funcID, {T.at(2)}, T.at(3));
+        tm.CreateBindFunctionConstraint(funcID, funcVar, {T.at(0)}, T.at(1));
+        tm.CreateArrayElementConstraint(T.at(2), T.at(3));
+        const auto bindID = tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+        CPPTEST_EXPECT_THAT(tm.registerType("unit" + std::to_string(unit)));
+
+        const auto solution = tm.solve();
+        CPPTEST_ASSERT_THAT(solution.has_value());
+        CPPTEST_EXPECT_EQ(solution->GetResolvedType(T.at(1)), tm.getRegisteredType("float"));
+
+        tm.resetToMark(mark);
+        CPPTEST_EXPECT_EQ(tm.getConstraints().size(), preludeConstraints);
+        CPPTEST_EXPECT_EQ(tm.getConstraintStore().size(), preludeConstraints);
+        CPPTEST_EXPECT_THAT(tm.getConstraint(bindID) == nullptr);
+        CPPTEST_EXPECT_THAT(tm.getTypeTable().size() >= preludeTypes);
+        CPPTEST_EXPECT_THAT(tm.hasRegisteredType("unit" + std::to_string(unit)));
+    }
+
+    CPPTEST_EXPECT_THAT(tm.hasRegisteredType("int"));
+    CPPTEST_EXPECT_THAT(tm.isConvertible("int", "float"));
+}
+
+NEW_TEST(TypeManagerTest, SolveChainsConversionsWhenTransitive) {
+    getDefaultTypeManager(tm);
+    tm.registerType("short");
+    CPPTEST_ASSERT_THAT(tm.setConvertible("short", "int"));
+
+    // let a: Short = 1; let b: Double = a
+    const auto T = CreateMultipleSymbols(tm, 2);
+    tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("short"));
+    tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("double"));
+    tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+    CPPTEST_EXPECT_FALSE(tm.solve().has_value());
+
+    // The matrix is rebuilt after the change, and short -> int -> double is allowed.
+    tm.setConvertibleTransitive(true);
+    CPPTEST_EXPECT_THAT(tm.solve().has_value());
+    CPPTEST_EXPECT_FALSE(tm.isConvertible("short", "double"));
+}
+
+NEW_TEST(TypeManagerTest, BenchmarkPreludeLoad10kTypes) {
+    constexpr std::size_t numTypes = 10000;
+    typecheck::TypeManager tm;
+
+#ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
+    const auto start = std::chrono::steady_clock::now();
+#endif
+    for (std::size_t i = 0; i < numTypes; ++i) {
+        CPPTEST_ASSERT_THAT(tm.registerType("type" + std::to_string(i)));
+    }
+    for (std::size_t i = 1; i < numTypes; ++i) {
+        CPPTEST_ASSERT_THAT(tm.setConvertible("type" + std::to_string(i - 1), "type" + std::to_string(i)));
+    }
+    for (std::size_t i = 0; i < numTypes; ++i) {
+        CPPTEST_ASSERT_THAT(tm.hasRegisteredType("type" + std::to_string(i)));
+    }
+
+#ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Prelude load (" << numTypes << " types): " << elapsed.count() << "ms" << std::endl;
+#endif
+    CPPTEST_EXPECT_FALSE(tm.hasRegisteredType("type" + std::to_string(numTypes)));
+}
+
 CPPTEST_END_CLASS(TypeManagerTest)
\ No newline at end of file
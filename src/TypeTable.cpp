@@ -0,0 +1,179 @@
+#include "typecheck/TypeTable.hpp"
+#include "typecheck/Debug.hpp"
+#include "typecheck/FunctionDefinition.hpp"
+#include "typecheck/GenericType.hpp"
+
+#include <functional>
+#include <utility>
+
+namespace {
+	void hash_combine(std::size_t& seed, const std::size_t value) {
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+}
+
+auto typecheck::TypeTable::Node::operator==(const Node& other) const noexcept -> bool {
+	return this->kind == other.kind &&
+		this->funcID == other.funcID &&
+		this->returnType == other.returnType &&
+		this->params == other.params &&
+		this->name == other.name;
+}
+
+auto typecheck::TypeTable::hash(const Node& node) noexcept -> std::size_t {
+	std::size_t seed = std::hash<std::string>()(node.name);
+	hash_combine(seed, static_cast<std::size_t>(node.kind));
+	hash_combine(seed, std::hash<long long>()(node.funcID));
+	hash_combine(seed, node.returnType);
+	for (const auto& param : node.params) {
+		hash_combine(seed, param);
+	}
+	return seed;
+}
+
+auto typecheck::TypeTable::lookup(const Node& node, const std::size_t hash) const -> IDType {
+	const auto [begin, end] = this->index.equal_range(hash);
+	for (auto it = begin; it != end; ++it) {
+		if (this->nodes.at(it->second) == node) {
+			return it->second;
+		}
+	}
+	return npos;
+}
+
+auto typecheck::TypeTable::insert(Node&& node, const Type& type) -> IDType {
+	const auto h = hash(node);
+	const auto found = this->lookup(node, h);
+	if (found != npos) {
+		return found;
+	}
+
+	TYPECHECK_ASSERT(this->nodes.size() < npos, "Exhausted type table IDs.");
+	const auto id = static_cast<IDType>(this->nodes.size());
+	this->nodes.emplace_back(std::move(node));
+	this->types.emplace_back(type);
+	this->index.emplace(h, id);
+	return id;
+}
+
+auto typecheck::TypeTable::intern(const Type& type) -> IDType {
+	Node node;
+	if (type.has_generic()) {
+		const auto& generic = type.generic();
+		node.kind = Kind::Generic;
+		node.name = generic.name();
+		for (std::size_t i = 0; i < generic.type_params_size(); ++i) {
+			node.params.push_back(this->intern(generic.type_params(i)));
+		}
+	} else if (type.has_func()) {
+		const auto& func = type.func();
+		node.kind = Kind::Func;
+		node.name = func.name();
+		node.funcID = func.id();
+		for (std::size_t i = 0; i < func.args_size(); ++i) {
+			node.params.push_back(this->intern(func.args(i)));
+		}
+		if (func.has_returntype()) {
+			node.returnType = this->intern(func.returntype());
+		}
+	}
+
+	return this->insert(std::move(node), type);
+}
+
+auto typecheck::TypeTable::intern_generic(const std::string& name, const std::vector<IDType>& params) -> IDType {
+	Node node;
+	node.kind = Kind::Generic;
+	node.name = name;
+	node.params = params;
+
+	const auto found = this->lookup(node, hash(node));
+	if (found != npos) {
+		return found;
+	}
+
+	GenericType generic(name);
+	for (const auto& param : params) {
+		generic.add_type_param()->CopyFrom(this->get(param));
+	}
+	return this->insert(std::move(node), Type(generic));
+}
+
+auto typecheck::TypeTable::find(const Type& type) const -> IDType {
+	Node node;
+	if (type.has_generic()) {
+		const auto& generic = type.generic();
+		node.kind = Kind::Generic;
+		node.name = generic.name();
+		for (std::size_t i = 0; i < generic.type_params_size(); ++i) {
+			const auto param = this->find(generic.type_params(i));
+			if (param == npos) {
+				return npos;
+			}
+			node.params.push_back(param);
+		}
+	} else if (type.has_func()) {
+		const auto& func = type.func();
+		node.kind = Kind::Func;
+		node.name = func.name();
+		node.funcID = func.id();
+		for (std::size_t i = 0; i < func.args_size(); ++i) {
+			const auto arg = this->find(func.args(i));
+			if (arg == npos) {
+				return npos;
+			}
+			node.params.push_back(arg);
+		}
+		if (func.has_returntype()) {
+			node.returnType = this->find(func.returntype());
+			if (node.returnType == npos) {
+				return npos;
+			}
+		}
+	}
+
+	return this->lookup(node, hash(node));
+}
+
+void typecheck::TypeTable::truncate(const std::size_t size) {
+	while (this->nodes.size() > size) {
+		const auto id = static_cast<IDType>(this->nodes.size() - 1);
+		const auto [begin, end] = this->index.equal_range(hash(this->nodes.back()));
+		for (auto it = begin; it != end; ++it) {
+			if (it->second == id) {
+				this->index.erase(it);
+				break;
+			}
+		}
+		this->nodes.pop_back();
+		this->types.pop_back();
+	}
+}
+
+auto typecheck::TypeTable::get(const IDType id) const -> const Type& {
+	return this->types.at(id);
+}
+
+auto typecheck::TypeTable::size() const noexcept -> std::size_t {
+	return this->nodes.size();
+}
+
+auto typecheck::TypeTable::has_generic(const IDType id) const -> bool {
+	return this->nodes.at(id).kind == Kind::Generic;
+}
+
+auto typecheck::TypeTable::has_func(const IDType id) const -> bool {
+	return this->nodes.at(id).kind == Kind::Func;
+}
+
+auto typecheck::TypeTable::name(const IDType id) const -> const std::string& {
+	return this->nodes.at(id).name;
+}
+
+auto typecheck::TypeTable::params(const IDType id) const -> const std::vector<IDType>& {
+	return this->nodes.at(id).params;
+}
+
+auto typecheck::TypeTable::returntype(const IDType id) const -> IDType {
+	return this->nodes.at(id).returnType;
+}
@@ -0,0 +1,83 @@
+#include "cpptest/cpptest.hpp"
+#include "typecheck/FunctionDefinition.hpp"
+#include "typecheck/GenericType.hpp"
+#include "typecheck/Type.hpp"
+#include "typecheck/TypeTable.hpp"
+
+class TypeTableTest : public cpptest::BaseCppTest {
+public:
+    void SetUp() {
+        // Run before every test
+    }
+
+    void TearDown() {
+        // Run After every test
+    }
+};
+
+namespace {
+    auto arrayOf(const std::string& element) -> typecheck::Type {
+        typecheck::GenericType arrayType("Array");
+        arrayType.add_type_param()->CopyFrom(typecheck::Type(typecheck::GenericType(element)));
+        return {arrayType};
+    }
+}
+
+CPPTEST_CLASS(TypeTableTest)
+
+NEW_TEST(TypeTableTest, InternSameTypeOnce) {
+    typecheck::TypeTable table;
+    const auto a = table.intern(typecheck::Type(typecheck::GenericType("int")));
+    const auto b = table.intern(typecheck::Type(typecheck::GenericType("int")));
+    CPPTEST_EXPECT_EQ(a, b);
+    CPPTEST_EXPECT_EQ(table.size(), 1);
+    CPPTEST_EXPECT_EQ(table.name(a), "int");
+}
+
+NEW_TEST(TypeTableTest, InternDistinctTypes) {
+    typecheck::TypeTable table;
+    const auto a = table.intern(typecheck::Type(typecheck::GenericType("int")));
+    const auto b = table.intern(typecheck::Type(typecheck::GenericType("float")));
+    CPPTEST_EXPECT_NEQ(a, b);
+}
+
+NEW_TEST(TypeTableTest, InternArrayParams) {
+    typecheck::TypeTable table;
+    const auto intArray = table.intern(arrayOf("int"));
+    const auto floatArray = table.intern(arrayOf("float"));
+    CPPTEST_EXPECT_NEQ(intArray, floatArray);
+    CPPTEST_EXPECT_EQ(table.intern(arrayOf("int")), intArray);
+
+    // The element is interned alongside the array.
+    const auto intType = table.find(typecheck::Type(typecheck::GenericType("int")));
+    CPPTEST_ASSERT_THAT(intType != typecheck::TypeTable::npos);
+    CPPTEST_EXPECT_EQ(table.params(intArray).size(), 1);
+    CPPTEST_EXPECT_EQ(table.params(intArray).at(0), intType);
+    CPPTEST_EXPECT_EQ(table.intern_generic("Array", {intType}), intArray);
+    CPPTEST_EXPECT_EQ(table.get(intArray), arrayOf("int"));
+}
+
+NEW_TEST(TypeTableTest, InternFunctionSignature) {
+    typecheck::FunctionDefinition func;
+    func.set_name("foo");
+    func.set_id(42);
+    func.add_args()->mutable_generic()->set_name("int");
+    func.mutable_returntype()->mutable_generic()->set_name("double");
+
+    typecheck::TypeTable table;
+    const auto a = table.intern(typecheck::Type(func));
+    CPPTEST_EXPECT_EQ(table.intern(typecheck::Type(func)), a);
+    CPPTEST_EXPECT_THAT(table.has_func(a));
+    CPPTEST_EXPECT_EQ(table.name(table.returntype(a)), "double");
+
+    func.add_args()->mutable_generic()->set_name("float");
+    CPPTEST_EXPECT_NEQ(table.intern(typecheck::Type(func)), a);
+}
+
+NEW_TEST(TypeTableTest, FindDoesNotInsert) {
+    typecheck::TypeTable table;
+    CPPTEST_EXPECT_EQ(table.find(arrayOf("int")), typecheck::TypeTable::npos);
+    CPPTEST_EXPECT_EQ(table.size(), 0);
+}
+
+CPPTEST_END_CLASS(TypeTableTest)
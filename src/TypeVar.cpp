@@ -1,11 +1,11 @@
 #include "typecheck/TypeVar.hpp"
 
-#include <utility>
+#include <string>
 
-typecheck::TypeVar::TypeVar(std::string s) : _symbol(std::move(s)) {}
+typecheck::TypeVar::TypeVar(const IDType id) noexcept : _id(id) {}
 
 auto typecheck::TypeVar::operator==(const TypeVar& other) const noexcept -> bool {
-	return this->_symbol == other._symbol;
+	return this->_id == other._id;
 }
 
 auto typecheck::TypeVar::operator!=(const TypeVar& other) const noexcept -> bool {
@@ -13,21 +13,32 @@ auto typecheck::TypeVar::operator!=(const TypeVar& other) const noexcept -> bool
 }
 
 auto typecheck::TypeVar::operator<(const TypeVar& other) const noexcept -> bool {
-	return this->_symbol < other._symbol;
+	return this->_id < other._id;
 }
 
 void typecheck::TypeVar::CopyFrom(const TypeVar& other) {
-	this->_symbol = other.symbol();
+	this->_id = other._id;
 }
 
-auto typecheck::TypeVar::symbol() const -> std::string {
-	return this->_symbol;
+auto typecheck::TypeVar::id() const noexcept -> IDType {
+	return this->_id;
+}
+
+void typecheck::TypeVar::set_id(const IDType id) noexcept {
+	this->_id = id;
 }
 
-void typecheck::TypeVar::set_symbol(const std::string& s) {
-	this->_symbol = s;
+auto typecheck::TypeVar::empty() const noexcept -> bool {
+	return this->_id == npos;
+}
+
+auto typecheck::TypeVar::symbol() const -> std::string {
+	if (this->empty()) {
+		return "";
+	}
+	return "T" + std::to_string(this->_id);
 }
 
 auto typecheck::TypeVar::ShortDebugString() const -> std::string {
-	return "{ \"symbol\": \"" + this->_symbol + "\" }";
+	return "{ \"symbol\": \"" + this->symbol() + "\" }";
 }
@@ -14,15 +14,23 @@ public:
 
 CPPTEST_CLASS(TypeVarTest)
 
-NEW_TEST(TypeVarTest, CheckSetString) {
+NEW_TEST(TypeVarTest, CheckDefaultEmpty) {
 	typecheck::TypeVar t;
-	t.set_symbol("Hello World");
-	CPPTEST_EXPECT_EQ(t.symbol(), "Hello World");
+	CPPTEST_EXPECT_THAT(t.empty());
+	CPPTEST_EXPECT_EQ(t.symbol(), "");
+}
+
+NEW_TEST(TypeVarTest, CheckSetID) {
+	typecheck::TypeVar t;
+	t.set_id(42);
+	CPPTEST_EXPECT_FALSE(t.empty());
+	CPPTEST_EXPECT_EQ(t.id(), 42);
+	CPPTEST_EXPECT_EQ(t.symbol(), "T42");
 }
 
 NEW_TEST(TypeVarTest, CopyVar) {
 	typecheck::TypeVar t;
-	t.set_symbol("Hello World");
+	t.set_id(7);
 	typecheck::TypeVar g;
 	g.CopyFrom(t);
 	CPPTEST_EXPECT_EQ(g.symbol(), t.symbol());
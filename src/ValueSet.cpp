@@ -0,0 +1,120 @@
+#include "ValueSet.hpp"
+
+#include <algorithm>
+#include <bit>
+
+typecheck::ValueSet::const_iterator::const_iterator(const ValueSet* set, const std::size_t bit) : owner(set), position(bit) {}
+
+auto typecheck::ValueSet::const_iterator::operator*() const noexcept -> value_type {
+	return static_cast<value_type>(this->position);
+}
+
+auto typecheck::ValueSet::const_iterator::operator++() -> const_iterator& {
+	this->position = this->owner->next(this->position + 1);
+	return *this;
+}
+
+auto typecheck::ValueSet::const_iterator::operator++(int) -> const_iterator {
+	auto copy = *this;
+	++*this;
+	return copy;
+}
+
+typecheck::ValueSet::ValueSet(const std::span<const ValueTable::IDType> values) {
+	for (const auto value : values) {
+		this->insert(value);
+	}
+}
+
+void typecheck::ValueSet::insert(const ValueTable::IDType value) {
+	const auto word = value / wordBits;
+	if (word >= this->bits.size()) {
+		this->bits.resize(word + 1, 0);
+	}
+	this->bits[word] |= Word{1} << (value % wordBits);
+}
+
+auto typecheck::ValueSet::contains(const ValueTable::IDType value) const noexcept -> bool {
+	const auto word = value / wordBits;
+	return word < this->bits.size() && ((this->bits[word] >> (value % wordBits)) & 1U) != 0;
+}
+
+auto typecheck::ValueSet::size() const noexcept -> std::size_t {
+	std::size_t count = 0;
+	for (const auto word : this->bits) {
+		count += static_cast<std::size_t>(std::popcount(word));
+	}
+	return count;
+}
+
+auto typecheck::ValueSet::empty() const noexcept -> bool {
+	return std::all_of(this->bits.begin(), this->bits.end(), [](const Word word) { return word == 0; });
+}
+
+auto typecheck::ValueSet::front() const noexcept -> ValueTable::IDType {
+	const auto bit = this->next(0);
+	return bit < this->bits.size() * wordBits ? static_cast<ValueTable::IDType>(bit) : ValueTable::npos;
+}
+
+auto typecheck::ValueSet::intersects(const ValueSet& other) const noexcept -> bool {
+	const auto words = std::min(this->bits.size(), other.bits.size());
+	for (std::size_t i = 0; i < words; ++i) {
+		if ((this->bits[i] & other.bits[i]) != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+auto typecheck::ValueSet::words() const noexcept -> std::span<const Word> {
+	return this->bits;
+}
+
+auto typecheck::ValueSet::operator&=(const ValueSet& other) -> ValueSet& {
+	this->bits.resize(std::min(this->bits.size(), other.bits.size()));
+	for (std::size_t i = 0; i < this->bits.size(); ++i) {
+		this->bits[i] &= other.bits[i];
+	}
+	return *this;
+}
+
+auto typecheck::ValueSet::operator|=(const ValueSet& other) -> ValueSet& {
+	this->bits.resize(std::max(this->bits.size(), other.bits.size()), 0);
+	for (std::size_t i = 0; i < other.bits.size(); ++i) {
+		this->bits[i] |= other.bits[i];
+	}
+	return *this;
+}
+
+auto typecheck::ValueSet::operator==(const ValueSet& other) const noexcept -> bool {
+	// Trailing zero words don't change the set.
+	const auto& shorter = this->bits.size() < other.bits.size() ? this->bits : other.bits;
+	const auto& longer = this->bits.size() < other.bits.size() ? other.bits : this->bits;
+	return std::equal(shorter.begin(), shorter.end(), longer.begin()) &&
+		std::all_of(longer.begin() + static_cast<std::ptrdiff_t>(shorter.size()), longer.end(), [](const Word word) { return word == 0; });
+}
+
+auto typecheck::ValueSet::begin() const -> const_iterator {
+	return const_iterator(this, this->next(0));
+}
+
+auto typecheck::ValueSet::end() const -> const_iterator {
+	return const_iterator(this, this->bits.size() * wordBits);
+}
+
+auto typecheck::ValueSet::next(const std::size_t bit) const noexcept -> std::size_t {
+	const auto total = this->bits.size() * wordBits;
+	if (bit >= total) {
+		return total;
+	}
+
+	auto word = bit / wordBits;
+	auto remaining = this->bits[word] & (~Word{0} << (bit % wordBits));
+	while (remaining == 0) {
+		if (++word == this->bits.size()) {
+			return total;
+		}
+		remaining = this->bits[word];
+	}
+	return word * wordBits + static_cast<std::size_t>(std::countr_zero(remaining));
+}
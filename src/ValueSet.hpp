@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ValueTable.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+namespace typecheck {
+	// Set of solver values as a bitset over value IDs, the domain of a solver variable
+	// while the solve propagates. A few hundred values fit in a handful of words, so
+	// intersections and size tests are word operations rather than list merges.
+	class ValueSet {
+	public:
+		using Word = std::uint64_t;
+		static constexpr std::size_t wordBits = 64;
+
+		// Visits the values in ascending order.
+		class const_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = ValueTable::IDType;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = value_type;
+
+			const_iterator() = default;
+			const_iterator(const ValueSet* set, std::size_t bit);
+
+			auto operator*() const noexcept -> value_type;
+			auto operator++() -> const_iterator&;
+			auto operator++(int) -> const_iterator;
+			auto operator==(const const_iterator& other) const noexcept -> bool = default;
+
+		private:
+			const ValueSet* owner = nullptr;
+			std::size_t position = 0;
+		};
+
+		ValueSet() = default;
+		explicit ValueSet(std::span<const ValueTable::IDType> values);
+
+		void insert(ValueTable::IDType value);
+
+		[[nodiscard]] auto contains(ValueTable::IDType value) const noexcept -> bool;
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+		[[nodiscard]] auto empty() const noexcept -> bool;
+		// Smallest value, `ValueTable::npos` when empty.
+		[[nodiscard]] auto front() const noexcept -> ValueTable::IDType;
+		[[nodiscard]] auto intersects(const ValueSet& other) const noexcept -> bool;
+		[[nodiscard]] auto words() const noexcept -> std::span<const Word>;
+
+		auto operator&=(const ValueSet& other) -> ValueSet&;
+		auto operator|=(const ValueSet& other) -> ValueSet&;
+		auto operator==(const ValueSet& other) const noexcept -> bool;
+
+		[[nodiscard]] auto begin() const -> const_iterator;
+		[[nodiscard]] auto end() const -> const_iterator;
+
+	private:
+		// First set bit at or after `bit`, the bit count when there is none.
+		[[nodiscard]] auto next(std::size_t bit) const noexcept -> std::size_t;
+
+		std::vector<Word> bits;
+	};
+}
@@ -0,0 +1,55 @@
+#include "cpptest/cpptest.hpp"
+#include "ValueSet.hpp"
+
+#include <vector>
+
+class ValueSetTest : public cpptest::BaseCppTest {
+public:
+    void SetUp() {
+        // Run before every test
+    }
+
+    void TearDown() {
+        // Run After every test
+    }
+};
+
+CPPTEST_CLASS(ValueSetTest)
+
+NEW_TEST(ValueSetTest, IteratesInValueOrder) {
+    const std::vector<typecheck::ValueTable::IDType> ids{130, 3, 64, 3, 0};
+    const typecheck::ValueSet set(ids);
+
+    CPPTEST_EXPECT_EQ(set.size(), 4);
+    CPPTEST_EXPECT_EQ(set.front(), 0);
+    const std::vector<typecheck::ValueTable::IDType> visited(set.begin(), set.end());
+    CPPTEST_EXPECT_EQ(visited, (std::vector<typecheck::ValueTable::IDType>{0, 3, 64, 130}));
+}
+
+NEW_TEST(ValueSetTest, IntersectAndUnionAcrossWidths) {
+    typecheck::ValueSet narrow(std::vector<typecheck::ValueTable::IDType>{1, 2});
+    const typecheck::ValueSet wide(std::vector<typecheck::ValueTable::IDType>{2, 200});
+
+    CPPTEST_EXPECT_TRUE(narrow.intersects(wide));
+    auto both = narrow;
+    both &= wide;
+    CPPTEST_EXPECT_EQ(both.size(), 1);
+    CPPTEST_EXPECT_TRUE(both.contains(2));
+    CPPTEST_EXPECT_FALSE(both.contains(200));
+
+    narrow |= wide;
+    CPPTEST_EXPECT_EQ(narrow.size(), 3);
+    CPPTEST_EXPECT_TRUE(narrow.contains(200));
+}
+
+NEW_TEST(ValueSetTest, EmptyIgnoresWidth) {
+    typecheck::ValueSet set(std::vector<typecheck::ValueTable::IDType>{100});
+    set &= typecheck::ValueSet(std::vector<typecheck::ValueTable::IDType>{5});
+
+    CPPTEST_EXPECT_TRUE(set.empty());
+    CPPTEST_EXPECT_EQ(set.front(), typecheck::ValueTable::npos);
+    CPPTEST_EXPECT_TRUE(set == typecheck::ValueSet());
+    CPPTEST_EXPECT_TRUE(set.begin() == set.end());
+}
+
+CPPTEST_END_CLASS(ValueSetTest)
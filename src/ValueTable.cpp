@@ -0,0 +1,121 @@
+#include "ValueTable.hpp"
+#include "typecheck/Debug.hpp"
+
+#include <string>
+
+namespace {
+	// An ID is stored in its value as `idBytes` bytes of 7 bits each, the high bit always
+	// set so no byte is NUL. Reading one back is a fixed number of shifts, no parsing.
+	constexpr std::size_t idBytes = 5;
+
+	auto encode(const typecheck::ValueTable::IDType id) -> std::string {
+		std::string bytes(idBytes, '\0');
+		for (std::size_t i = 0; i < idBytes; ++i) {
+			bytes[i] = static_cast<char>(0x80u | ((id >> (7 * i)) & 0x7fu));
+		}
+		return bytes;
+	}
+}
+
+typecheck::ValueTable::ValueTable(const TypeTable& table) : types(table) {}
+
+auto typecheck::ValueTable::insert(const Entry& entry) -> IDType {
+	TYPECHECK_ASSERT(this->entries.size() < npos, "Exhausted solver value IDs.");
+	const auto id = static_cast<IDType>(this->entries.size());
+	this->entries.push_back(entry);
+	this->values.emplace_back(encode(id));
+	return id;
+}
+
+auto typecheck::ValueTable::type(const TypeTable::IDType id) -> IDType {
+	const auto found = this->find_type(id);
+	if (found != npos) {
+		return found;
+	}
+
+	// Keep a single value per array type, however it was reached.
+	IDType value = npos;
+	if (this->types.has_generic(id) && this->types.name(id) == "Array" && this->types.params(id).size() == 1) {
+		value = this->array(this->type(this->types.params(id).front()));
+	} else {
+		value = this->insert(Entry{Kind::Type, id, npos, {}});
+	}
+	this->byType.emplace(id, value);
+	return value;
+}
+
+auto typecheck::ValueTable::array(const IDType element) -> IDType {
+	const auto found = this->find_array(element);
+	if (found != npos) {
+		return found;
+	}
+
+	const auto value = this->insert(Entry{Kind::Array, TypeTable::npos, element, {}});
+	this->byElement.emplace(element, value);
+	return value;
+}
+
+auto typecheck::ValueTable::function(const OverloadKey& key) -> IDType {
+	const auto found = this->find_function(key);
+	if (found != npos) {
+		return found;
+	}
+
+	const auto value = this->insert(Entry{Kind::Function, TypeTable::npos, npos, key});
+	this->byFunction.emplace(key, value);
+	return value;
+}
+
+auto typecheck::ValueTable::find_type(const TypeTable::IDType id) const -> IDType {
+	const auto it = this->byType.find(id);
+	return it == this->byType.end() ? npos : it->second;
+}
+
+auto typecheck::ValueTable::find_array(const IDType element) const -> IDType {
+	const auto it = this->byElement.find(element);
+	return it == this->byElement.end() ? npos : it->second;
+}
+
+auto typecheck::ValueTable::find_function(const OverloadKey& key) const -> IDType {
+	const auto it = this->byFunction.find(key);
+	return it == this->byFunction.end() ? npos : it->second;
+}
+
+auto typecheck::ValueTable::kind(const IDType id) const -> Kind {
+	return this->entries.at(id).kind;
+}
+
+auto typecheck::ValueTable::typeID(const IDType id) const -> TypeTable::IDType {
+	return this->entries.at(id).type;
+}
+
+auto typecheck::ValueTable::element(const IDType id) const -> IDType {
+	return this->entries.at(id).element;
+}
+
+auto typecheck::ValueTable::overload(const IDType id) const -> const OverloadKey& {
+	const auto& entry = this->entries.at(id);
+	TYPECHECK_ASSERT(entry.kind == Kind::Function, "Value is not a function.");
+	return entry.overload;
+}
+
+auto typecheck::ValueTable::value(const IDType id) const -> const constraint::Value& {
+	return this->values.at(id);
+}
+
+auto typecheck::ValueTable::decode(const constraint::Value& value) const -> IDType {
+	const auto& bytes = value.to_string();
+	if (bytes.size() != idBytes) {
+		return npos;
+	}
+
+	std::uint64_t id = 0;
+	for (std::size_t i = 0; i < idBytes; ++i) {
+		id |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i]) & 0x7fu) << (7 * i);
+	}
+	return id < this->entries.size() ? static_cast<IDType>(id) : npos;
+}
+
+auto typecheck::ValueTable::size() const noexcept -> std::size_t {
+	return this->entries.size();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "typecheck/FunctionVar.hpp"
+#include "typecheck/TypeTable.hpp"
+
+#include "constraint/Domain.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace typecheck {
+	// Side table for the values handed to the constraint solver during a single solve.
+	// Every candidate is a small integer ID, stored verbatim in a constraint::Value made
+	// once up front; the entry for an ID describes what the value is, so constraint checks
+	// read the ID straight back out of the value and compare integers.
+	class ValueTable {
+	public:
+		using IDType = std::uint32_t;
+		static constexpr IDType npos = std::numeric_limits<IDType>::max();
+
+		enum class Kind : std::uint8_t {
+			Type = 0, // An interned type, `type()`
+			Array,    // Array of another value, `element()`
+			Function, // A function overload, `overload()`
+		};
+
+		explicit ValueTable(const TypeTable& table);
+
+		// Value for an interned type. `Array<T>` maps to the array of `T`'s value.
+		auto type(TypeTable::IDType id) -> IDType;
+		auto array(IDType element) -> IDType;
+		auto function(const OverloadKey& key) -> IDType;
+
+		// Lookups that never add an entry, `npos` if absent.
+		[[nodiscard]] auto find_type(TypeTable::IDType id) const -> IDType;
+		[[nodiscard]] auto find_array(IDType element) const -> IDType;
+		[[nodiscard]] auto find_function(const OverloadKey& key) const -> IDType;
+
+		[[nodiscard]] auto kind(IDType id) const -> Kind;
+		[[nodiscard]] auto typeID(IDType id) const -> TypeTable::IDType;
+		[[nodiscard]] auto element(IDType id) const -> IDType;
+		[[nodiscard]] auto overload(IDType id) const -> const OverloadKey&;
+
+		// Solver encoding of a value, and back. `decode` reads fixed-width bytes, it never
+		// formats or parses text.
+		[[nodiscard]] auto value(IDType id) const -> const constraint::Value&;
+		[[nodiscard]] auto decode(const constraint::Value& value) const -> IDType;
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+
+	private:
+		struct Entry {
+			Kind kind = Kind::Type;
+			TypeTable::IDType type = TypeTable::npos;
+			IDType element = npos;
+			OverloadKey overload;
+		};
+
+		auto insert(const Entry& entry) -> IDType;
+
+		const TypeTable& types;
+		std::vector<Entry> entries;
+		std::vector<constraint::Value> values;
+		std::unordered_map<TypeTable::IDType, IDType> byType;
+		std::unordered_map<IDType, IDType> byElement;
+		std::unordered_map<OverloadKey, IDType> byFunction;
+	};
+}